@@ -0,0 +1,421 @@
+// ArcFlowModel.cpp
+#include "ArcFlowModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+/**
+ * @brief check, if the arc-flow model can be built for an instance
+ *
+ * @param ins pointer to problem-instance
+ *
+ * @return true, if the capacity and all weights are integral (see Instance::setIntegral()) and the capacity is at most
+ * 10^8, so every load fits into an int
+ */
+bool ArcFlowModel::isApplicable(Instance* ins) { return ins->_integral && ins->int_b <= 100000000; }
+
+/**
+ * @brief Construct a new Arc Flow Model:: Arc Flow Model object
+ *
+ * @param ins pointer to problem-instance, isApplicable(ins) has to be true
+ *
+ * @note This code is a constructor for the ArcFlowModel class. It creates a SCIP environment and sets the specific
+ * parameters. It aggregates the items into item types and builds the reduced graph. It then creates one integer
+ * variable per arc and adds the flow conservation and demand constraints, each by a single call from the arrays of its
+ * variables and coefficients.
+ */
+ArcFlowModel::ArcFlowModel(Instance* ins)
+{
+   _ins      = ins; // initialize the private pointer variable to the instance object
+   _capacity = (int) _ins->int_b;
+
+   // create a SCIP environment and load all defaults
+   SCIPcreate(&_scipAF);
+   SCIPincludeDefaultPlugins(_scipAF);
+
+   // create an empty model
+   SCIPcreateProbBasic(_scipAF, "Arc Flow Model BPP");
+
+   // set the objective sense to minimize (not mandatory, default is minimize)
+   SCIPsetObjsense(_scipAF, SCIP_OBJSENSE_MINIMIZE);
+
+   // the objective counts bins, so it is always integral
+   SCIPsetObjIntegral(_scipAF);
+
+   // call the created function set all optional SCIPParameters
+   setSCIPParameters();
+
+   // create helping-dummy for the name of variables and constraints
+   char var_cons_name[255];
+
+   // #####################################################################################################################
+   //  Aggregate the items into item types
+   // #####################################################################################################################
+
+   vector<int> order(_ins->_nbItems);
+   iota(order.begin(), order.end(), 0);
+   stable_sort(order.begin(), order.end(), [this](int a, int b) { return _ins->par_w[a] > _ins->par_w[b]; });
+
+   _typeOfItem.resize(_ins->_nbItems, -1);
+   for( int i : order )
+   {
+      int weight = (int) _ins->int_w[i];
+
+      if( _typeWeight.empty() || _typeWeight.back() != weight )
+      {
+         _typeWeight.push_back(weight);
+         _typeDemand.push_back(0);
+         _typeItems.push_back({});
+      }
+
+      _typeDemand.back()++;
+      _typeItems.back().push_back(i);
+      _typeOfItem[i] = (int) _typeWeight.size() - 1;
+   }
+
+   int nbTypes = (int) _typeWeight.size();
+
+   // #####################################################################################################################
+   //  Build the reduced graph
+   // #####################################################################################################################
+
+   // only the loads, which can be reached with the types processed so far, get a node, so the memory depends on the
+   // size of the graph and not on the capacity
+   vector<int> nodes = {0}; // load of every node
+   _nodeOf[0]        = 0;
+   _outArcs.resize(1);
+
+   // lastType[n] = k, if an item arc of type k leaving node n has already been created
+   vector<int> lastType = {-1};
+
+   for( int k = 0; k < nbTypes; ++k )
+   {
+      if( _typeWeight[k] > _capacity || _typeWeight[k] == 0 )
+         continue; // items heavier than b can not be packed, items of weight 0 need no arc
+
+      size_t nbOldNodes = nodes.size();
+
+      // a chain of at most d_k arcs of type k starts in every load, which was reached by the types 1, ..., k-1
+      for( size_t n = 0; n < nbOldNodes; ++n )
+      {
+         int d = nodes[n];
+
+         for( int m = 0; m < _typeDemand[k] && d + _typeWeight[k] <= _capacity; ++m, d += _typeWeight[k] )
+         {
+            int tail = _nodeOf.at(d);
+            if( lastType[tail] == k )
+               continue;
+            lastType[tail] = k;
+
+            int head = d + _typeWeight[k];
+            if( _nodeOf.emplace(head, (int) nodes.size()).second )
+            {
+               nodes.push_back(head);
+               lastType.push_back(-1);
+               _outArcs.emplace_back();
+            }
+
+            _itemArcOf[(long long) d * nbTypes + k] = (int) _arcTail.size();
+            _outArcs[tail].push_back((int) _arcTail.size());
+            _arcTail.push_back(d);
+            _arcHead.push_back(head);
+            _arcType.push_back(k);
+         }
+      }
+   }
+
+   // loss arcs: from every reached load 0 < d < b directly to b
+   vector<int> loads = nodes;
+   sort(loads.begin(), loads.end());
+   for( int d : loads )
+   {
+      if( d == 0 || d == _capacity )
+         continue;
+
+      _outArcs[_nodeOf.at(d)].push_back((int) _arcTail.size());
+      _arcTail.push_back(d);
+      _arcHead.push_back(_capacity);
+      _arcType.push_back(-1);
+   }
+
+   // #####################################################################################################################
+   //  Create and add all variables
+   // #####################################################################################################################
+
+   // integer variable F_a, only the arcs leaving 0 start a new bin and count in the objective
+
+   _var_F.resize(_arcTail.size(), nullptr);
+
+   for( size_t a = 0; a < _arcTail.size(); ++a )
+   {
+      SCIPsnprintf(var_cons_name, 255, "F_%d_%d_%d", _arcTail[a], _arcHead[a], _arcType[a]);
+
+      SCIPcreateVarBasic(_scipAF,
+                         &_var_F[a],                                                  // returns the new variable
+                         var_cons_name,                                               // name
+                         0,                                                           // lower bound
+                         _arcType[a] >= 0 ? _typeDemand[_arcType[a]] : _ins->_nbItems, // upper bound
+                         _arcTail[a] == 0 ? 1 : 0,                                    // objective function coefficient
+                         SCIP_VARTYPE_INTEGER);                                       // variable type
+
+      SCIPaddVar(_scipAF, _var_F[a]);
+   }
+
+   // #####################################################################################################################
+   //  Add restrictions
+   // #####################################################################################################################
+
+   // incoming arcs of every node, the arcs into b are not needed
+   vector<vector<int>> inArcs(nodes.size());
+   for( size_t a = 0; a < _arcTail.size(); ++a )
+   {
+      if( _arcHead[a] != _capacity )
+         inArcs[_nodeOf.at(_arcHead[a])].push_back((int) a);
+   }
+
+   vector<SCIP_VAR*> cons_vars;
+   vector<SCIP_Real> cons_coefs;
+
+   // flow conservation: sum(a in in(d), F_a) - sum(a in out(d), F_a) = 0 for all loads 0 < d < b
+   for( int d : loads )
+   {
+      if( d == 0 || d == _capacity )
+         continue;
+
+      cons_vars.clear();
+      cons_coefs.clear();
+      for( int a : inArcs[_nodeOf.at(d)] )
+      {
+         cons_vars.push_back(_var_F[a]);
+         cons_coefs.push_back(1);
+      }
+      for( int a : _outArcs[_nodeOf.at(d)] )
+      {
+         cons_vars.push_back(_var_F[a]);
+         cons_coefs.push_back(-1);
+      }
+
+      SCIPsnprintf(var_cons_name, 255, "flow_conservation_%d", d);
+
+      SCIP_CONS* cons;
+      SCIPcreateConsBasicLinear(_scipAF,
+                                &cons,
+                                var_cons_name,
+                                (int) cons_vars.size(),
+                                cons_vars.data(),
+                                cons_coefs.data(),
+                                0,  // lhs
+                                0); // rhs
+      SCIPaddCons(_scipAF, cons);
+      _cons_flow_conservation.push_back(cons);
+   }
+
+   // demand: sum(a arc of type k, F_a) >= d_k for all item types k
+   vector<vector<SCIP_VAR*>> typeVars(nbTypes);
+   for( size_t a = 0; a < _arcTail.size(); ++a )
+   {
+      if( _arcType[a] >= 0 )
+         typeVars[_arcType[a]].push_back(_var_F[a]);
+   }
+
+   _cons_demand.resize(nbTypes, nullptr);
+   for( int k = 0; k < nbTypes; ++k )
+   {
+      // items of weight 0 fit into every used bin
+      if( _typeWeight[k] == 0 )
+         continue;
+
+      vector<SCIP_Real> ones(typeVars[k].size(), 1);
+
+      SCIPsnprintf(var_cons_name, 255, "demand_%d", _typeWeight[k]);
+
+      SCIPcreateConsBasicLinear(_scipAF,
+                                &_cons_demand[k],
+                                var_cons_name,
+                                (int) typeVars[k].size(),
+                                typeVars[k].data(),
+                                ones.data(),
+                                _typeDemand[k],         // lhs
+                                SCIPinfinity(_scipAF)); // rhs
+      SCIPaddCons(_scipAF, _cons_demand[k]);
+   }
+}
+
+/**
+ * @brief Destroy the Arc Flow Model:: Arc Flow Model object
+ *
+ * @note This is the destructor for the Arc Flow Model class. It releases all constraints and variables and then frees
+ * the SCIP object.
+ */
+ArcFlowModel::~ArcFlowModel()
+{
+   for( SCIP_CONS*& cons : _cons_flow_conservation )
+   {
+      SCIPreleaseCons(_scipAF, &cons);
+   }
+
+   for( SCIP_CONS*& cons : _cons_demand )
+   {
+      if( cons != nullptr )
+         SCIPreleaseCons(_scipAF, &cons);
+   }
+
+   for( SCIP_VAR*& var : _var_F )
+   {
+      SCIPreleaseVar(_scipAF, &var);
+   }
+
+   SCIPfree(&_scipAF);
+}
+
+/**
+ * @brief set optional SCIP parameters
+ *
+ * @note The same parameters as for the compact model. For more information on these parameters, please refer to the
+ * SCIP documentation at https://www.scipopt.org/doc/html/PARAMETERS.php.
+ */
+void ArcFlowModel::setSCIPParameters()
+{
+   SCIPsetRealParam(_scipAF, "limits/time", 1e+20);    // default 1e+20 s
+   SCIPsetRealParam(_scipAF, "limits/gap", 0);         // default 0
+   SCIPsetIntParam(_scipAF, "display/verblevel", 4);   // default 4
+   SCIPsetBoolParam(_scipAF, "display/lpinfo", FALSE); // default FALSE
+};
+
+/**
+ * @brief pass the packing of the heuristic to SCIP as a starting solution
+ *
+ * @param heur pointer to the heuristic, which has already been run
+ *
+ * @note Every bin of the heuristic packing is turned into a path: its items are stacked by decreasing weight, which
+ * only uses arcs of the reduced graph, and a loss arc leads from the load of the bin to b. The flow on every arc is the
+ * number of bins using it.
+ */
+void ArcFlowModel::addStartSolution(Heuristic* heur)
+{
+   if( !heur->_feasible )
+      return;
+
+   int            nbTypes = (int) _typeWeight.size();
+   vector<double> flow(_arcTail.size(), 0);
+
+   for( int j = 0; j < heur->_nbBinsUsed; ++j )
+   {
+      // types of the items in bin j, sorted by decreasing weight = increasing type
+      vector<int> types;
+      for( int i = 0; i < _ins->_nbItems; ++i )
+      {
+         if( heur->_bin_of_item[i] == j && _typeWeight[_typeOfItem[i]] > 0 )
+            types.push_back(_typeOfItem[i]);
+      }
+      sort(types.begin(), types.end());
+
+      int load = 0;
+      for( int k : types )
+      {
+         flow[_itemArcOf.at((long long) load * nbTypes + k)] += 1;
+         load += _typeWeight[k];
+      }
+
+      // loss arc from the load of the bin to b
+      if( load > 0 && load < _capacity )
+      {
+         for( int a : _outArcs[_nodeOf.at(load)] )
+         {
+            if( _arcType[a] == -1 )
+               flow[a] += 1;
+         }
+      }
+   }
+
+   SCIP_Bool stored;
+
+   SCIPcreateSol(_scipAF, &_sol, NULL);
+   for( size_t a = 0; a < _arcTail.size(); ++a )
+   {
+      if( flow[a] > 0 )
+         SCIPsetSolVal(_scipAF, _sol, _var_F[a], flow[a]);
+   }
+   SCIPaddSol(_scipAF, _sol, &stored);
+   SCIPfreeSol(_scipAF, &_sol);
+};
+
+/**
+ * @brief solve the arc-flow model
+ *
+ * @note This function solves the arc-flow model using SCIPsolve. It prints a message indicating that it is starting
+ * to solve the arc-flow model by the message handler of SCIP.
+ */
+void ArcFlowModel::solve()
+{
+   SCIPinfoMessage(_scipAF,
+                   NULL,
+                   "___________________________________________________________________________________________\n");
+   SCIPinfoMessage(_scipAF, NULL, "start Solving arc-flow Model: \n");
+   SCIPsolve(_scipAF);
+};
+
+/**
+ * @brief Display the bins of the best solution
+ *
+ * @note The flow is decomposed into paths from 0 to b, every path is a bin. The item arcs of a path are replaced by
+ * the next not yet packed items of their type.
+ */
+void ArcFlowModel::displaySolution()
+{
+   _sol = SCIPgetBestSol(_scipAF);
+   if( _sol == NULL )
+   {
+      cout << "no solution found\n";
+      return;
+   }
+
+   vector<int> flow(_arcTail.size());
+   for( size_t a = 0; a < _arcTail.size(); ++a )
+   {
+      flow[a] = (int) lround(SCIPgetSolVal(_scipAF, _sol, _var_F[a]));
+   }
+
+   vector<size_t> nextItem(_typeWeight.size(), 0); // next not yet packed item of every type
+   int            bin = 0;
+
+   cout << "objective value: " << SCIPgetSolOrigObj(_scipAF, _sol) << "\n";
+
+   while( true )
+   {
+      int d = 0;
+
+      vector<int> items;
+      while( d != _capacity )
+      {
+         int next = -1;
+         for( int a : _outArcs[_nodeOf.at(d)] )
+         {
+            if( flow[a] > 0 )
+            {
+               next = a;
+               break;
+            }
+         }
+         if( next == -1 )
+            break;
+
+         --flow[next];
+         int k = _arcType[next];
+         if( k >= 0 && nextItem[k] < _typeItems[k].size() )
+            items.push_back(_typeItems[k][nextItem[k]++]);
+         d = _arcHead[next];
+      }
+
+      if( d == 0 )
+         break;
+
+      cout << "bin " << bin++ << ":";
+      for( int i : items )
+      {
+         cout << " " << i;
+      }
+      cout << "\n";
+   }
+};
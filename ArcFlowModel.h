@@ -0,0 +1,101 @@
+// ArcFlowModel.h
+#pragma once
+
+#include "Heuristic.h"
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+#include "objscip/objscipdefplugins.h"
+
+#include <unordered_map>
+
+using namespace scip;
+
+/**
+ * @brief The arc-flow formulation of Valerio de Carvalho for the BPP with integer weights and capacity
+ *
+ * @param _scipAF pointer to the scip environment for the arc-flow model
+ *
+ * @param _sol pointer to the solution of the arc-flow model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _type item types: items with the same weight are aggregated into one type with a demand
+ *
+ * @param _arc arcs of the graph
+ *
+ * @param _var pointer to various SCIP-variables
+ *
+ * @param _cons pointer to various SCIP-constraints
+ *
+ * @note ArcFlowModel is a class that implements the arc-flow formulation for the Bin Packing Problem (BPP). The nodes
+ * of the graph are the loads 0, ..., b of a bin, every path from 0 to b is the filling of a single bin. An item arc
+ * (d, d + w_k) packs an item of type k on top of the load d, a loss arc (d, b) leaves the rest of the bin empty. The
+ * integer variable F_a is the number of bins using arc a. Items with identical weights are aggregated into item types,
+ * so the model has one demand constraint per type instead of one constraint per item. The graph is reduced as
+ * proposed by Valerio de Carvalho: the types are sorted by decreasing weight and item arcs of type k only start in
+ * loads, which can be reached by items of the types 1, ..., k within their demands. The model size is
+ * pseudo-polynomial in b and independent of the number of items, its LP bound equals the bound of the pattern model.
+ * Only the reached loads are nodes, so the memory grows with the graph and not with b. The model can only be built,
+ * if the capacity and all weights are integral (see isApplicable()).
+ */
+class ArcFlowModel
+{
+
+public:
+   // constructor
+   ArcFlowModel(Instance* ins);
+
+   // destructor
+   ~ArcFlowModel();
+
+   // solve the problem
+   void solve();
+
+   // display the solution
+   void displaySolution();
+
+   // set all optional SCIP-Parameters
+   void setSCIPParameters();
+
+   // pass the packing of the heuristic to SCIP as a starting solution
+   void addStartSolution(Heuristic* heur);
+
+   // returns the scip environment, e.g. to change parameters or to read the statistics after solving
+   SCIP* getSCIP() { return _scipAF; }
+
+   // true, if the capacity and all weights of the instance are integral
+   static bool isApplicable(Instance* ins);
+
+private:
+   SCIP*     _scipAF; // pointer to the scip environment for the arc-flow model
+   SCIP_SOL* _sol;    // pointer to the solution of the arc-flow model
+
+   Instance* _ins; // pointer to the instance
+
+   int _capacity; // integral capacity b
+
+   // item types, sorted by decreasing weight
+   vector<int>         _typeWeight; // weight of every item type
+   vector<int>         _typeDemand; // number of items of every item type
+   vector<vector<int>> _typeItems;  // items i \in I of every item type
+   vector<int>         _typeOfItem; // item type of every item i \in I
+
+   // arcs
+   vector<int>                   _arcTail;   // load at the tail of every arc
+   vector<int>                   _arcHead;   // load at the head of every arc
+   vector<int>                   _arcType;   // item type of every arc, -1 for a loss arc
+   unordered_map<int, int>       _nodeOf;    // node of every reached load
+   vector<vector<int>>           _outArcs;   // arcs leaving every node, dimension: number of nodes
+   unordered_map<long long, int> _itemArcOf; // item arc of type k leaving load d, key: d * number of types + k
+
+   // variables
+   vector<SCIP_VAR*> _var_F; // F_a: number of bins using arc a
+
+   // constraints
+   vector<SCIP_CONS*> _cons_flow_conservation; // flow conservation in every load 0 < d < b, which is a node of the
+                                               // graph, dimension: number of inner nodes
+   vector<SCIP_CONS*> _cons_demand;            // demand constraint: every item of type k is packed
+                                               // dimension: number of item types
+};
@@ -0,0 +1,190 @@
+// BatchSolver.cpp
+#include "BatchSolver.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <thread>
+
+/**
+ * @brief Construct a new BatchSolver:: BatchSolver object
+ *
+ * @param files paths of all instance files
+ *
+ * @param settings settings used for every solve
+ *
+ * @param outputFile path of the result file, JSONL if it ends with ".jsonl", CSV otherwise
+ */
+BatchSolver::BatchSolver(const vector<string>& files, const SolverSettings& settings, const string& outputFile)
+{
+   _files      = files;
+   _settings   = settings;
+   _nbFinished = 0;
+
+   _jsonl = outputFile.size() >= 6 && outputFile.compare(outputFile.size() - 6, 6, ".jsonl") == 0;
+
+   _out.open(outputFile);
+   if( !_out )
+      cout << "BatchSolver : can not open the result file " << outputFile << "\n";
+
+   if( !_jsonl )
+      _out << SolveResult::headerCSV() << "\n";
+}
+
+/**
+ * @brief replace every directory by the .bpp- and .txt-files it contains
+ *
+ * @param paths paths of files and directories
+ *
+ * @return paths of all instance files
+ *
+ * @note The files of a directory are sorted by name, so the order of the result file is reproducible for a single
+ * thread. The .txt-files are the BPPLIB instances and the instances written by BPPBench generate. Files given directly
+ * are used as they are. A directory, which can not be read, is reported and skipped; a path, whose type can not be
+ * determined, is used as a file, so its error is reported by the solve.
+ */
+vector<string> BatchSolver::collectFiles(const vector<string>& paths)
+{
+   vector<string> files;
+
+   for( const string& path : paths )
+   {
+      error_code ec;
+      if( filesystem::is_directory(path, ec) )
+      {
+         vector<string> dirFiles;
+         for( filesystem::directory_iterator entry(path, ec), end; !ec && entry != end; entry.increment(ec) )
+         {
+            error_code       typeEc;
+            filesystem::path extension = entry->path().extension();
+            if( entry->is_regular_file(typeEc) && (extension == ".bpp" || extension == ".txt") )
+               dirFiles.push_back(entry->path().string());
+         }
+         if( ec )
+            cout << "BatchSolver : can not read the directory " << path << ": " << ec.message() << "\n";
+         sort(dirFiles.begin(), dirFiles.end());
+         files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+      }
+      else
+      {
+         files.push_back(path);
+      }
+   }
+
+   return files;
+}
+
+/**
+ * @brief solve all instances
+ *
+ * @param nbThreads number of worker threads, at least 1
+ *
+ * @return false, if the result file could not be opened, then no instance is solved
+ *
+ * @note The file size is used as an estimate of the solving time: the jobs are sorted by decreasing file size and
+ * dealt round-robin to the workers. The function returns, when all workers have finished.
+ */
+bool BatchSolver::run(int nbThreads)
+{
+   if( !_out )
+      return false;
+
+   nbThreads = max(1, min(nbThreads, (int) _files.size()));
+
+   // estimate the size of every instance
+   vector<uintmax_t> size(_files.size(), 0);
+   for( size_t f = 0; f < _files.size(); ++f )
+   {
+      error_code ec;
+      size[f] = filesystem::file_size(_files[f], ec);
+   }
+
+   vector<int> order(_files.size());
+   iota(order.begin(), order.end(), 0);
+   stable_sort(order.begin(), order.end(), [&size](int a, int b) { return size[a] > size[b]; });
+
+   // deal the jobs round-robin
+   _queues     = vector<deque<int>>(nbThreads);
+   _queueMutex = vector<mutex>(nbThreads);
+   for( size_t k = 0; k < order.size(); ++k )
+   {
+      _queues[k % nbThreads].push_back(order[k]);
+   }
+
+   // start the workers and wait for them
+   vector<thread> workers;
+   for( int w = 0; w < nbThreads; ++w )
+   {
+      workers.emplace_back(&BatchSolver::worker, this, w);
+   }
+   for( thread& t : workers )
+   {
+      t.join();
+   }
+
+   _out.close();
+   return true;
+}
+
+/**
+ * @brief get the next job for worker w
+ *
+ * @note The own queue is used from the front (largest instances first), the other queues are robbed from the back.
+ * As no new jobs are created while solving, the worker can stop, as soon as all queues are empty.
+ */
+bool BatchSolver::nextJob(int w, int& job)
+{
+   int nbQueues = (int) _queues.size();
+
+   for( int k = 0; k < nbQueues; ++k )
+   {
+      int               victim = (w + k) % nbQueues;
+      lock_guard<mutex> lock(_queueMutex[victim]);
+
+      if( _queues[victim].empty() )
+         continue;
+
+      if( victim == w )
+      {
+         job = _queues[victim].front();
+         _queues[victim].pop_front();
+      }
+      else
+      {
+         job = _queues[victim].back();
+         _queues[victim].pop_back();
+      }
+      return true;
+   }
+
+   return false;
+}
+
+/**
+ * @brief main loop of a worker thread: solve jobs, until there is no job left
+ */
+void BatchSolver::worker(int w)
+{
+   int job;
+
+   while( nextJob(w, job) )
+   {
+      SolveResult result = solveInstance(_files[job], _settings);
+      writeResult(result);
+   }
+}
+
+/**
+ * @brief write a result to the result file and print the progress to the console
+ */
+void BatchSolver::writeResult(const SolveResult& result)
+{
+   lock_guard<mutex> lock(_outMutex);
+
+   _out << (_jsonl ? result.toJSON() : result.toCSV()) << "\n";
+   _out.flush();
+
+   ++_nbFinished;
+   cout << "[" << _nbFinished << "/" << _files.size() << "] " << result._instance << ": " << result._status
+        << ", bins " << result._bins << ", bound " << result._bound << ", time " << result._time << " s" << endl;
+}
@@ -0,0 +1,58 @@
+// BatchSolver.h
+#pragma once
+
+#include "Solver.h"
+
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief solves many instance files in parallel on a work-stealing thread pool
+ *
+ * @param _files paths of all instance files
+ *
+ * @param _settings settings used for every solve
+ *
+ * @param _queues one job queue per worker thread
+ *
+ * @param _out stream of the result file (CSV or JSONL)
+ *
+ * @note Every worker thread owns a queue of jobs (indices into _files). The jobs are sorted by decreasing file size and
+ * dealt round-robin, so every worker starts with its largest instances. A worker takes its next job from the front of
+ * its own queue; if its queue is empty, it steals a job from the back of another worker's queue. Every job calls
+ * solveInstance(), which creates its own Instance, model and SCIP environment inside the worker thread, so the
+ * workers do not share any SCIP data. Every result is written to the result file as soon as it is available, so
+ * the results of a long batch run are not lost, if it is aborted.
+ */
+class BatchSolver
+{
+public:
+   // constructor, the format of the result file is JSONL, if its name ends with ".jsonl", CSV otherwise
+   BatchSolver(const vector<string>& files, const SolverSettings& settings, const string& outputFile);
+
+   // solve all instances with the given number of threads, false without solving, if the result file is not open
+   bool run(int nbThreads);
+
+   // replace every directory in paths by the .bpp- and .txt-files it contains, sorted by name
+   static vector<string> collectFiles(const vector<string>& paths);
+
+private:
+   // main loop of a worker thread
+   void worker(int w);
+
+   // get the next job for worker w, from its own queue or stolen from another queue, false if all queues are empty
+   bool nextJob(int w, int& job);
+
+   // write a result to the result file and print the progress
+   void writeResult(const SolveResult& result);
+
+   vector<string> _files;    // paths of all instance files
+   SolverSettings _settings; // settings used for every solve
+
+   vector<deque<int>> _queues;      // job queue of every worker
+   vector<mutex>      _queueMutex;  // mutex of every job queue
+   ofstream           _out;         // result file
+   bool               _jsonl;       // true: JSONL, false: CSV
+   mutex              _outMutex;    // mutex of the result file and the console
+   int                _nbFinished;  // number of finished jobs
+};
@@ -0,0 +1,356 @@
+// Benchmark.cpp
+#include "CompactModel.h"
+#include "Generator.h"
+#include "Heuristic.h"
+#include "LowerBound.h"
+#include "Solver.h"
+
+#include <filesystem>
+#include <sstream>
+
+/**
+ * @brief print the command line of the benchmark
+ */
+static void printUsage(const char* program)
+{
+   cout << "usage:\n"
+        << "  " << program << " generate <family> <n> <seed> <file>\n"
+        << "      write a generated instance, family: uniform, triplets, scholl or hard28\n"
+        << "  " << program << " run <model> <family> <n> <count> [time-limit] [dir]\n"
+        << "      generate <count> instances with the seeds 1, ..., count into dir (default: bench), solve them one\n"
+        << "      after the other and print read, build and solve time of every instance as CSV\n"
+        << "  " << program << " check <model> <file> <bins | infeasible> [time-limit] [options]\n"
+        << "      solve a single instance, exit code 0 if the result is optimal with the given number of bins;\n"
+        << "      options: --no-reduce, --no-bounds (build the model without the reduction and even if the heuristic\n"
+        << "      reaches the lower bounds), --binpacking, --rounding <freq>,\n"
+        << "      --cuts <freq>, --portfolio-size <n>, --telemetry (see BPP, the result is printed as JSON)\n"
+        << "  " << program << " bounds <file> <L1> <L2> <L3> <DFF>\n"
+        << "      compute the lower bounds of an instance, exit code 0 if they are equal to the given values\n"
+        << "  " << program << " edit <file> <bins> <change>... <bins> [options]\n"
+        << "      solve the compact model, change it and solve it again, exit code 0 if both results are optimal with\n"
+        << "      the given numbers of bins; change: add:<weight>, remove:<item> or weight:<item>:<weight>;\n"
+        << "      options: --binpacking, --rounding <freq>, --cuts <freq> (see BPP)\n";
+}
+
+/**
+ * @brief generate a series of instances and solve them one after the other
+ *
+ * @return 0 upon completion, 1 for an unknown family or a number of triplet items, which is no multiple of 3
+ *
+ * @note The instances are solved sequentially in the calling thread, so the times are not disturbed by other solves.
+ * Every instance is written to a file first, so the read time includes the parser. The last line is the mean of every
+ * time over all instances.
+ */
+static int runSeries(const SolverSettings& settings, const string& family, int nbItems, int count, const string& dir)
+{
+   filesystem::create_directories(dir);
+
+   cout << SolveResult::headerCSV() << ",known_optimum\n";
+
+   double sumTime = 0, sumRead = 0, sumBuild = 0, sumSolve = 0;
+   int    nbOptimal = 0, nbWrong = 0;
+
+   for( int seed = 1; seed <= count; ++seed )
+   {
+      Instance ins;
+      if( !generateInstance(family, nbItems, (uint64_t) seed, ins) )
+      {
+         cout << "can not generate " << family << " with " << nbItems << " items\n";
+         return 1;
+      }
+
+      string fileName = dir + "/" + family + "_" + to_string(nbItems) + "_" + to_string(seed) + ".txt";
+      writeInstance(ins, fileName);
+
+      SolveResult result = solveInstance(fileName, settings);
+      int         known  = knownOptimum(family, nbItems);
+
+      cout << result.toCSV() << "," << known << endl;
+
+      sumTime += result._time;
+      sumRead += result._readTime;
+      sumBuild += result._buildTime;
+      sumSolve += result._solveTime;
+      nbOptimal += result._status == "optimal";
+      nbWrong += known >= 0 && result._status == "optimal" && result._bins != known;
+   }
+
+   cout << "# mean of " << count << " instances: time " << sumTime / count << ", read_time " << sumRead / count
+        << ", build_time " << sumBuild / count << ", solve_time " << sumSolve / count << ", optimal " << nbOptimal
+        << "/" << count << "\n";
+
+   return nbWrong > 0 ? 1 : 0;
+}
+
+/**
+ * @brief solve a single instance and compare the result with the expected optimum
+ *
+ * @return 0, if the result is the expected one, 1 otherwise
+ *
+ * @note With telemetry, the result is printed as JSON with the statistics of SCIP, so a test can check, that the own
+ * plugins of the compact model have really been called.
+ */
+static int check(const SolverSettings& settings, const string& fileName, const string& expected)
+{
+   SolveResult result = solveInstance(fileName, settings);
+
+   cout << (settings._telemetry ? result.toJSON() : result.toCSV()) << "\n";
+
+   bool ok;
+   if( expected == "infeasible" )
+      ok = result._status == "infeasible";
+   else
+      ok = result._status == "optimal" && result._bins == stod(expected);
+
+   if( !ok )
+      cout << "check failed: expected " << expected << "\n";
+
+   return ok ? 0 : 1;
+}
+
+/**
+ * @brief compute the lower bounds of an instance and compare them with the expected values
+ *
+ * @param expected expected values of L1, L2, L3 and DFF
+ *
+ * @return 0, if every bound is the expected one, 1 otherwise
+ *
+ * @note All bounds are computed (no upper bound stops the computation early), so every bound is checked on its own.
+ */
+static int checkBounds(const string& fileName, const vector<int>& expected)
+{
+   Instance ins;
+   if( !ins.read(fileName) )
+   {
+      cout << "can not read " << fileName << "\n";
+      return 1;
+   }
+
+   LowerBound bound(&ins);
+   bound.run();
+   bound.display();
+
+   vector<int> computed = {bound._L1, bound._L2, bound._L3, bound._LDFF};
+   if( computed != expected )
+   {
+      cout << "check failed: expected L1 " << expected[0] << ", L2 " << expected[1] << ", L3 " << expected[2]
+           << ", DFF " << expected[3] << "\n";
+      return 1;
+   }
+
+   return 0;
+}
+
+/**
+ * @brief apply a single change to the compact model
+ *
+ * @param model compact model, which has been solved
+ *
+ * @param change add:<weight>, remove:<item> or weight:<item>:<weight>
+ *
+ * @return true, if the change is valid and accepted by the model
+ */
+static bool applyChange(CompactModel* model, const string& change)
+{
+   vector<string> field;
+   stringstream   stream(change);
+   for( string part; getline(stream, part, ':'); )
+   {
+      field.push_back(part);
+   }
+
+   try
+   {
+      if( field.size() == 2 && field[0] == "add" )
+         return model->addItem(stod(field[1])) >= 0;
+      if( field.size() == 2 && field[0] == "remove" )
+         return model->removeItem(stoi(field[1]));
+      if( field.size() == 3 && field[0] == "weight" )
+         return model->changeWeight(stoi(field[1]), stod(field[2]));
+   }
+   catch( const exception& )
+   {
+   }
+
+   return false;
+}
+
+/**
+ * @brief solve the compact model of an instance, change it incrementally and solve it again
+ *
+ * @param settings settings of the solve, only the plugins of the compact model are used
+ *
+ * @param fileName path to the instance file
+ *
+ * @param before expected optimal number of bins of the instance
+ *
+ * @param changes changes of the model (see applyChange())
+ *
+ * @param after expected optimal number of bins after the changes
+ *
+ * @return 0, if both solves are optimal with the expected numbers of bins, 1 otherwise
+ *
+ * @note This checks the incremental interface of CompactModel (addItem(), removeItem(), changeWeight()), which keeps
+ * the model and passes the repaired packing of the first solve as starting solution to the second one. As in
+ * solveInstance(), the number of bins of the model is the number of bins of the heuristic, so adding items may add
+ * bins to the model. The plugins see the changes as well, e.g. the bound cut of the separator has to ignore removed
+ * items.
+ */
+static int checkEdits(const SolverSettings& settings,
+                      const string&         fileName,
+                      const string&         before,
+                      const vector<string>& changes,
+                      const string&         after)
+{
+   Instance ins;
+   if( !ins.read(fileName) )
+   {
+      cout << "can not read " << fileName << "\n";
+      return 1;
+   }
+
+   Heuristic heur(&ins);
+   heur.run();
+   if( heur._feasible )
+      ins._nbBins = heur._nbBinsUsed;
+
+   CompactModel* model = new CompactModel(&ins);
+   if( settings._binPacking )
+      model->addBinPackingConstraint();
+   if( settings._roundingFreq >= 0 )
+      model->addRoundingHeuristic(settings._roundingFreq);
+   if( settings._cutsFreq >= 0 )
+      model->addSeparator(settings._cutsFreq);
+   model->addStartSolution(&heur);
+   SCIPsetMessagehdlrQuiet(model->getSCIP(), TRUE);
+
+   // true, if the model is solved to optimality with the expected number of bins
+   auto solved = [model](const string& expected) {
+      SCIP* scip = model->getSCIP();
+      model->solve();
+      cout << "status " << (SCIPgetStatus(scip) == SCIP_STATUS_OPTIMAL ? "optimal" : "not optimal") << ", bins "
+           << (SCIPgetNSols(scip) > 0 ? SCIPgetPrimalbound(scip) : -1) << "\n";
+      return SCIPgetStatus(scip) == SCIP_STATUS_OPTIMAL && SCIPgetNSols(scip) > 0
+             && SCIPgetPrimalbound(scip) == stod(expected);
+   };
+
+   bool ok = solved(before);
+   for( const string& change : changes )
+   {
+      if( !applyChange(model, change) )
+      {
+         cout << "edit rejected: " << change << "\n";
+         ok = false;
+         break;
+      }
+   }
+   ok = ok && solved(after);
+
+   delete model;
+
+   if( !ok )
+      cout << "check failed: expected " << before << " and " << after << "\n";
+
+   return ok ? 0 : 1;
+}
+
+/**
+ * @brief main-function of the benchmark
+ *
+ * @param argc number of arguments
+ *
+ * @param argv arguments: a command and its arguments (see printUsage())
+ *
+ * @return int 0 upon success, 1 for invalid arguments or a failed check
+ *
+ * @note The benchmark uses the same solveInstance() as the solver, so the times are exactly the times of the solver:
+ * reading the instance, building the model (including the heuristic starting solution) and solving it. The commands
+ * "check", "bounds" and "edit" are used by the CTest entries in CMakeLists.txt.
+ */
+int main(int argc, char** argv)
+{
+   if( argc < 2 )
+   {
+      printUsage(argv[0]);
+      return 1;
+   }
+
+   string         command = argv[1];
+   SolverSettings settings;
+   settings._verbose = false;
+
+   if( command == "generate" && argc == 6 )
+   {
+      Instance ins;
+      if( !generateInstance(argv[2], stoi(argv[3]), stoull(argv[4]), ins) || !writeInstance(ins, argv[5]) )
+      {
+         cout << "can not generate " << argv[5] << "\n";
+         return 1;
+      }
+      return 0;
+   }
+
+   if( command == "run" && argc >= 6 && argc <= 8 )
+   {
+      settings._model = argv[2];
+      if( argc >= 7 )
+         settings._timeLimit = stod(argv[6]);
+      return runSeries(settings, argv[3], stoi(argv[4]), stoi(argv[5]), argc == 8 ? argv[7] : "bench");
+   }
+
+   if( command == "check" && argc >= 5 )
+   {
+      settings._model = argv[2];
+      for( int a = 5; a < argc; ++a )
+      {
+         string arg = argv[a];
+         if( arg == "--no-reduce" )
+            settings._reduce = false;
+         else if( arg == "--no-bounds" )
+            settings._bounds = false;
+         else if( arg == "--binpacking" )
+            settings._binPacking = true;
+         else if( arg == "--rounding" && a + 1 < argc )
+            settings._roundingFreq = stoi(argv[++a]);
+         else if( arg == "--cuts" && a + 1 < argc )
+            settings._cutsFreq = stoi(argv[++a]);
+         else if( arg == "--portfolio-size" && a + 1 < argc )
+            settings._portfolioSize = stoi(argv[++a]);
+         else if( arg == "--telemetry" )
+            settings._telemetry = true;
+         else if( a == 5 )
+            settings._timeLimit = stod(arg);
+         else
+         {
+            printUsage(argv[0]);
+            return 1;
+         }
+      }
+      return check(settings, argv[3], argv[4]);
+   }
+
+   if( command == "bounds" && argc == 7 )
+      return checkBounds(argv[2], {stoi(argv[3]), stoi(argv[4]), stoi(argv[5]), stoi(argv[6])});
+
+   if( command == "edit" && argc >= 5 )
+   {
+      vector<string> args; // file, bins, changes and bins without the options
+      for( int a = 2; a < argc; ++a )
+      {
+         string arg = argv[a];
+         if( arg == "--binpacking" )
+            settings._binPacking = true;
+         else if( arg == "--rounding" && a + 1 < argc )
+            settings._roundingFreq = stoi(argv[++a]);
+         else if( arg == "--cuts" && a + 1 < argc )
+            settings._cutsFreq = stoi(argv[++a]);
+         else
+            args.push_back(arg);
+      }
+      if( args.size() >= 3 )
+         return checkEdits(settings, args[0], args[1], vector<string>(args.begin() + 2, args.end() - 1), args.back());
+   }
+
+   printUsage(argv[0]);
+   return 1;
+}
@@ -0,0 +1,376 @@
+// BranchAndBound.cpp
+#include "BranchAndBound.h"
+#include "LowerBound.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+/**
+ * @brief Construct a new BranchAndBound:: BranchAndBound object
+ *
+ * @param ins pointer to problem-instance, isApplicable(ins) has to be true
+ *
+ * @note The items are sorted by decreasing weight, the integral weights of the instance are copied in this order.
+ */
+BranchAndBound::BranchAndBound(Instance* ins)
+{
+   _ins        = ins;
+   _feasible   = false;
+   _optimal    = false;
+   _nbBinsUsed = 0;
+   _lowerBound = 0;
+   _nbNodes    = 0;
+   _stop       = false;
+   _truncated  = false;
+   _timeLimit  = 1e+20;
+   _nbChecks   = 0;
+   _depth      = 0;
+
+   // bounds the time of a single node, the memory of the enumeration does not depend on the number of completions
+   _maxCompletions = 100000;
+
+   _n = _ins->_nbItems;
+   _b = _ins->int_b;
+
+   _item.resize(_n);
+   iota(_item.begin(), _item.end(), 0);
+   stable_sort(_item.begin(), _item.end(), [this](int a, int b) { return _ins->par_w[a] > _ins->par_w[b]; });
+
+   _w.resize(_n);
+   _totalWeight = 0;
+   for( int p = 0; p < _n; ++p )
+   {
+      _w[p] = _ins->int_w[_item[p]];
+      _totalWeight += _w[p];
+   }
+}
+
+/**
+ * @brief check, if the branch-and-bound can be used for an instance
+ *
+ * @param ins pointer to problem-instance
+ *
+ * @return true, if the capacity and all weights are integral (see Instance::setIntegral())
+ */
+bool BranchAndBound::isApplicable(Instance* ins) { return ins->_integral && ins->int_b <= 1000000000000000LL; }
+
+/**
+ * @brief search an optimal packing
+ *
+ * @param heur pointer to the heuristic, which has already been run, its packing is the first incumbent
+ *
+ * @param timeLimit time limit in seconds, if it is reached, the best packing found so far is kept
+ *
+ * @note If the heuristic packing already reaches the best bound of LowerBound, no search is needed.
+ */
+void BranchAndBound::run(Heuristic* heur, double timeLimit)
+{
+   _start     = chrono::steady_clock::now();
+   _timeLimit = timeLimit;
+   _stop      = false;
+   _truncated = false;
+   _nbNodes   = 0;
+   _nbChecks  = 0;
+
+   _feasible = heur->_feasible;
+   if( !_feasible )
+      return;
+
+   _nbBinsUsed  = heur->_nbBinsUsed;
+   _bin_of_item = heur->_bin_of_item;
+
+   LowerBound bound(_ins);
+   bound.run(_nbBinsUsed);
+   _lowerBound = bound._best;
+
+   if( _lowerBound < _nbBinsUsed )
+   {
+      _remaining.assign((_n + 63) / 64, 0);
+      for( int p = 0; p < _n; ++p )
+      {
+         _remaining[p / 64] |= uint64_t(1) << (p % 64);
+      }
+      _bins.assign(_n, vector<int>());
+      _levels.assign(_n + 1, Level());
+      _depth = 0;
+
+      search(_totalWeight, 0);
+
+      // without a stop by the time limit or a cut by _maxCompletions, the search has proven the optimality
+      if( (!_stop && !_truncated) || _nbBinsUsed == _lowerBound )
+         _lowerBound = _nbBinsUsed;
+   }
+
+   _optimal = _lowerBound == _nbBinsUsed;
+}
+
+/**
+ * @brief check the time limit
+ *
+ * @return true, if the search is stopped by the bound or the time limit
+ *
+ * @note The clock is only read every 1024 calls.
+ */
+bool BranchAndBound::stopped()
+{
+   if( !_stop && (++_nbChecks & 1023) == 0
+       && chrono::duration<double>(chrono::steady_clock::now() - _start).count() > _timeLimit )
+      _stop = true;
+
+   return _stop;
+}
+
+/**
+ * @brief fill the next bin
+ *
+ * @param remainingWeight sum of the weights of the remaining items
+ *
+ * @param waste sum of the residual capacities of the filled bins
+ *
+ * @note A new incumbent is stored, if all items are packed. Otherwise the bin gets the largest remaining item and the
+ * search branches on all undominated completions of the bin. The budget is the waste, which the remaining bins may
+ * leave, if the packing shall use fewer bins than the incumbent. The candidates are stored in the Level of the depth,
+ * so their vectors are only allocated by the first node of every depth.
+ */
+void BranchAndBound::search(long long remainingWeight, long long waste)
+{
+   ++_nbNodes;
+   if( stopped() )
+      return;
+
+   // all items are packed: new incumbent
+   if( remainingWeight == 0 && none_of(_remaining.begin(), _remaining.end(), [](uint64_t word) { return word != 0; }) )
+   {
+      if( _depth < _nbBinsUsed )
+      {
+         _nbBinsUsed = _depth;
+         for( int j = 0; j < _nbBinsUsed; ++j )
+         {
+            for( int p : _bins[j] )
+            {
+               _bin_of_item[_item[p]] = j;
+            }
+         }
+         _stop = _nbBinsUsed == _lowerBound;
+      }
+      return;
+   }
+
+   long long budget = (long long) (_nbBinsUsed - 1) * _b - _totalWeight - waste;
+   if( budget < 0 || (long long) _depth + (remainingWeight + _b - 1) / _b >= _nbBinsUsed )
+      return;
+
+   Level& level          = _levels[_depth];
+   level.first           = -1;
+   level.budget          = budget;
+   level.remainingWeight = remainingWeight;
+   level.waste           = waste;
+   level.nbCompletions   = 0;
+   level.cand.clear();
+
+   // the largest remaining item is the lowest set bit, the candidates are all other remaining items
+   for( size_t word = 0; word < _remaining.size(); ++word )
+   {
+      for( uint64_t bits = _remaining[word]; bits != 0; bits &= bits - 1 )
+      {
+         int p = (int) (word * 64 + __builtin_ctzll(bits));
+         if( level.first == -1 )
+            level.first = p;
+         else
+            level.cand.push_back(p);
+      }
+   }
+
+   // suffix[idx] = sum of the weights of the candidates idx, ..., end
+   level.suffix.assign(level.cand.size() + 1, 0);
+   for( size_t idx = level.cand.size(); idx-- > 0; )
+   {
+      level.suffix[idx] = level.suffix[idx + 1] + _w[level.cand[idx]];
+   }
+
+   // smallest waste first: every pass branches on the completions with a waste in (low, high]
+   level.included.assign(level.cand.size(), 0);
+   for( level.low = -1, level.high = 0; level.low < budget && !_stop; level.low = level.high )
+   {
+      level.high = min(budget, 2 * level.high + 1);
+      completions(_depth, 0, _b - _w[level.first]);
+   }
+}
+
+/**
+ * @brief enumerate the undominated completions of a bin and branch on each of them
+ *
+ * @param depth depth of the node, whose bin is completed
+ *
+ * @param idx next candidate to decide
+ *
+ * @param residual residual capacity of the bin
+ *
+ * @note The candidate idx is first included, then excluded. If a candidate is excluded, all following candidates of the
+ * same weight are excluded as well, so every multiset of weights is enumerated only once. Candidates, which do not fit,
+ * are skipped. A branch is cut, if even all remaining candidates can not reduce the waste to the upper end of the waste
+ * window of the pass. Every undominated completion with a waste in the window is passed to branch() at once. The
+ * enumeration stops with the search (bound or time limit) and after _maxCompletions completions of the node, which
+ * marks the search as truncated.
+ */
+void BranchAndBound::completions(int depth, size_t idx, long long residual)
+{
+   Level& level = _levels[depth];
+   if( stopped() || level.nbCompletions > _maxCompletions )
+      return;
+
+   if( residual - level.suffix[idx] > level.high )
+      return;
+
+   const vector<int>& cand = level.cand;
+
+   // skip the candidates, which do not fit
+   while( idx < cand.size() && _w[cand[idx]] > residual )
+   {
+      ++idx;
+   }
+
+   if( idx < cand.size() )
+   {
+      long long weight = _w[cand[idx]];
+
+      level.included[idx] = 1;
+      completions(depth, idx + 1, residual - weight);
+      level.included[idx] = 0;
+
+      size_t next = idx + 1;
+      while( next < cand.size() && _w[cand[next]] == weight )
+      {
+         ++next;
+      }
+      completions(depth, next, residual);
+      return;
+   }
+
+   if( residual > level.high || residual <= level.low )
+      return;
+
+   // maximality and dominance: compare the excluded weights with the included weights
+   _excluded.clear();
+   _inside.clear();
+   for( size_t c = 0; c < cand.size(); ++c )
+   {
+      if( level.included[c] )
+         _inside.push_back(_w[cand[c]]);
+      else if( _excluded.empty() || _excluded.back() != _w[cand[c]] )
+         _excluded.push_back(_w[cand[c]]);
+   }
+
+   // is there an excluded weight in [low, high]? (excluded is sorted by decreasing weight)
+   auto exists = [this](long long low, long long high) {
+      auto it = lower_bound(_excluded.begin(), _excluded.end(), high, greater<long long>());
+      return it != _excluded.end() && *it >= low;
+   };
+
+   if( exists(0, residual) )
+      return; // not maximal
+
+   for( size_t a = 0; a < _inside.size(); ++a )
+   {
+      if( exists(_inside[a] + 1, _inside[a] + residual) )
+         return; // a single item can replace item a
+
+      for( size_t c = a + 1; c < _inside.size(); ++c )
+      {
+         if( exists(_inside[a] + _inside[c], _inside[a] + _inside[c] + residual) )
+            return; // a single item can replace the items a and c
+      }
+   }
+
+   if( ++level.nbCompletions > _maxCompletions )
+   {
+      _truncated = true;
+      return;
+   }
+
+   branch(depth, residual);
+}
+
+/**
+ * @brief pack the current completion of a bin and search the next bin
+ *
+ * @param depth depth of the node, whose bin is packed
+ *
+ * @param residual residual capacity of the bin with the completion
+ *
+ * @note The bin holds the largest remaining item and the included candidates of the Level. They are removed from the
+ * remaining items for the search below and restored afterwards.
+ */
+void BranchAndBound::branch(int depth, long long residual)
+{
+   Level&       level = _levels[depth];
+   vector<int>& bin   = _bins[depth];
+
+   bin.clear();
+   bin.push_back(level.first);
+   for( size_t c = 0; c < level.cand.size(); ++c )
+   {
+      if( level.included[c] )
+         bin.push_back(level.cand[c]);
+   }
+   for( int p : bin )
+   {
+      _remaining[p / 64] &= ~(uint64_t(1) << (p % 64));
+   }
+
+   _depth = depth + 1;
+   search(level.remainingWeight - (_b - residual), level.waste + residual);
+   _depth = depth;
+
+   for( int p : bin )
+   {
+      _remaining[p / 64] |= uint64_t(1) << (p % 64);
+   }
+}
+
+/**
+ * @brief check the best packing
+ *
+ * @return true, if every item is packed into one of the used bins and no bin exceeds the capacity
+ */
+bool BranchAndBound::verify()
+{
+   if( !_feasible )
+      return false;
+
+   vector<long long> load(_nbBinsUsed, 0);
+   for( int i = 0; i < _n; ++i )
+   {
+      if( _bin_of_item[i] < 0 || _bin_of_item[i] >= _nbBinsUsed )
+         return false;
+      load[_bin_of_item[i]] += _ins->int_w[i];
+   }
+
+   return all_of(load.begin(), load.end(), [this](long long l) { return l <= _b; });
+}
+
+/**
+ * @brief display the packing of the branch-and-bound
+ */
+void BranchAndBound::display()
+{
+   if( !_feasible )
+   {
+      cout << "Branch-and-bound: no feasible packing" << endl;
+      return;
+   }
+
+   cout << "Branch-and-bound: " << _nbBinsUsed << " bins, lower bound " << _lowerBound
+        << (_optimal ? " (optimal)" : "") << ", " << _nbNodes << " nodes" << endl;
+   for( int j = 0; j < _nbBinsUsed; ++j )
+   {
+      cout << "bin " << j << ":";
+      for( int i = 0; i < _n; ++i )
+      {
+         if( _bin_of_item[i] == j )
+            cout << " " << i;
+      }
+      cout << endl;
+   }
+}
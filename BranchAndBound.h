@@ -0,0 +1,108 @@
+// BranchAndBound.h
+#pragma once
+
+#include "Heuristic.h"
+#include "Instance.h"
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief exact combinatorial branch-and-bound for the BPP with integer weights, which does not need SCIP
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _feasible, _optimal, _nbBinsUsed, _lowerBound, _bin_of_item the best packing and its certificate
+ *
+ * @param _w, _item items sorted by decreasing weight
+ *
+ * @note The search is the bin-completion algorithm of Korf: every level of the depth-first search fills one bin
+ * completely. The bin gets the largest remaining item and one of its completions, i.e. a subset of the remaining items,
+ * which fits into the residual capacity. Only maximal completions (no remaining item fits in addition) are used, which
+ * are not dominated in the sense of Martello and Toth: a completion is dominated, if a single excluded item can replace
+ * one included item of smaller weight or two included items of at most its weight. The completions are generated
+ * lazily: the search branches on every completion as soon as it is enumerated, so no list of completions is stored. To
+ * try the completions with the smallest residual capacity (waste) first, the enumeration is repeated for the waste
+ * windows (-1, 0], (0, 1], (1, 3], (3, 7], ... up to the budget of the node. A node is pruned, if the bins used so far
+ * plus ceil(remaining weight / b) is not smaller than the best packing, i.e. if the waste of a node exceeds the waste
+ * allowed for a better packing. The search starts with the heuristic packing as incumbent and stops as soon as it
+ * reaches the best bound of LowerBound. The weights are stored as integers sorted by decreasing weight, the remaining
+ * items as a bitset in this order, so the largest remaining item is the lowest set bit. The time limit is checked in
+ * the nodes and in the enumeration of the completions, a node branches on at most _maxCompletions completions. If the
+ * search is finished (and neither stopped by the time limit nor cut by _maxCompletions), the packing is optimal and
+ * _optimal is true.
+ */
+class BranchAndBound
+{
+public:
+   // constructor
+   BranchAndBound(Instance* ins);
+
+   // true, if the capacity and all weights of the instance are integral
+   static bool isApplicable(Instance* ins);
+
+   // search an optimal packing, starting with the packing of the heuristic as incumbent
+   void run(Heuristic* heur, double timeLimit);
+
+   // check, that the best packing packs every item and respects the capacity of every bin
+   bool verify();
+
+   // display the packing
+   void display();
+
+   bool        _feasible;    // true, if a feasible packing was found
+   bool        _optimal;     // true, if the packing is proven to be optimal
+   int         _nbBinsUsed;  // number of used bins in the best packing
+   int         _lowerBound;  // lower bound on the number of bins
+   long long   _nbNodes;     // number of nodes (filled bins) of the search
+   vector<int> _bin_of_item; // bin of every item i \in I, dimension: _nbItems
+
+private:
+   // candidates of the bin filled at one depth of the search, reused by all nodes of this depth
+   struct Level
+   {
+      int               first;           // position of the largest remaining item
+      vector<int>       cand;            // positions of the other remaining items, sorted by decreasing weight
+      vector<long long> suffix;          // sum of the weights of the candidates from every index to the end
+      vector<char>      included;        // true for the candidates of the current completion
+      long long         budget;          // maximum waste of the bin
+      long long         low, high;       // the current pass enumerates the completions with a waste in (low, high]
+      long long         remainingWeight; // sum of the weights of the remaining items
+      long long         waste;           // sum of the residual capacities of the filled bins
+      long long         nbCompletions;   // number of completions, on which the node has branched
+   };
+
+   // fill the next bin with the largest remaining item and every undominated completion
+   void search(long long remainingWeight, long long waste);
+
+   // enumerate the undominated completions of the bin at a depth and branch on each of them
+   void completions(int depth, size_t idx, long long residual);
+
+   // pack the current completion of the bin at a depth and search the next bin
+   void branch(int depth, long long residual);
+
+   // true, if the search is stopped, checks the time limit every 1024 calls
+   bool stopped();
+
+   Instance* _ins; // pointer to the instance
+
+   int               _n;           // number of items
+   long long         _b;           // integral capacity
+   long long         _totalWeight; // sum of all weights, below 2^58 (see Instance::setIntegral())
+   vector<long long> _w;           // weight of every position, sorted by decreasing weight
+   vector<int>       _item;        // item i \in I at every position
+
+   vector<uint64_t>    _remaining; // bitset of the positions, which are not packed in the current node
+   vector<vector<int>> _bins;      // positions packed into every bin of the current node, dimension: _n
+   int                 _depth;     // number of filled bins of the current node
+   vector<Level>       _levels;    // candidates of every depth, dimension: _n + 1
+   vector<long long>   _excluded;  // buffer of the dominance check: distinct weights of the excluded candidates
+   vector<long long>   _inside;    // buffer of the dominance check: weights of the included candidates
+
+   chrono::steady_clock::time_point _start;          // start of run()
+   double                           _timeLimit;      // time limit in seconds
+   long long                        _nbChecks;       // number of calls of stopped()
+   long long                        _maxCompletions; // maximum number of completions per node
+   bool                             _stop;           // true, if the search is stopped by the bound or the time limit
+   bool                             _truncated;      // true, if a node had more than _maxCompletions completions
+};
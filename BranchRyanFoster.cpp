@@ -0,0 +1,116 @@
+// BranchRyanFoster.cpp
+#include "BranchRyanFoster.h"
+#include "ConsSameDiff.h"
+#include "PatternVardata.h"
+
+#include <cmath>
+#include <unordered_map>
+
+/**
+ * @brief Construct a new BranchRyanFoster:: BranchRyanFoster object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param ins pointer to the instance
+ *
+ * @note The priority is higher than the one of every default branching rule, so SCIP never branches on a single
+ * pattern variable.
+ */
+BranchRyanFoster::BranchRyanFoster(SCIP* scip, Instance* ins)
+    : ObjBranchrule(scip,
+                    "RyanFoster",                             // name
+                    "Ryan-Foster branching rule on item pairs", // description
+                    50000,                                    // priority
+                    -1,                                       // maximal depth, -1 = no limit
+                    1.0)                                      // maximal relative distance to the dual bound
+{
+   _ins = ins;
+}
+
+/**
+ * @brief branching rule for fractional LP solutions
+ *
+ * @note For every pair of items (i, k) the value sum(p: i, k in p, lambda_p) over all fractional pattern variables is
+ * collected in a hash map, as most pairs never appear together in a fractional pattern. The pair with the value
+ * closest to 0.5 is selected and two children are created: one with a SAME-constraint and one with a
+ * DIFFER-constraint on this pair.
+ */
+SCIP_DECL_BRANCHEXECLP(BranchRyanFoster::scip_execlp)
+{
+   *result = SCIP_DIDNOTRUN;
+
+   SCIP_VAR**  lpcands;
+   SCIP_Real*  lpcandssol;
+   int         nlpcands;
+
+   SCIP_CALL(SCIPgetLPBranchCands(scip, &lpcands, &lpcandssol, NULL, &nlpcands, NULL, NULL));
+
+   // sum of the LP values of all fractional patterns, which contain both items of the pair (i, k), key = i * n + k
+   unordered_map<long long, double> pairweights;
+
+   for( int v = 0; v < nlpcands; ++v )
+   {
+      PatternVardata* vardata = dynamic_cast<PatternVardata*>(SCIPgetObjVardata(scip, lpcands[v]));
+      if( vardata == NULL )
+         continue;
+
+      const vector<int>& items = vardata->_items;
+      for( size_t a = 0; a < items.size(); ++a )
+      {
+         for( size_t c = a + 1; c < items.size(); ++c )
+         {
+            pairweights[(long long) items[a] * _ins->_nbItems + items[c]] += lpcandssol[v];
+         }
+      }
+   }
+
+   // select the fractional pair closest to 0.5
+   long long bestpair  = -1;
+   double    bestscore = 1.0;
+   for( const auto& pair : pairweights )
+   {
+      if( SCIPisFeasIntegral(scip, pair.second) )
+         continue;
+
+      double score = fabs(pair.second - 0.5);
+      if( score < bestscore )
+      {
+         bestscore = score;
+         bestpair  = pair.first;
+      }
+   }
+
+   // no fractional pair: leave the decision to the other branching rules
+   if( bestpair == -1 )
+      return SCIP_OKAY;
+
+   int item1 = (int) (bestpair / _ins->_nbItems);
+   int item2 = (int) (bestpair % _ins->_nbItems);
+
+   // create the two children
+   SCIP_NODE* childsame;
+   SCIP_NODE* childdiffer;
+   SCIP_CALL(SCIPcreateChild(scip, &childsame, 0.0, SCIPgetLocalTransEstimate(scip)));
+   SCIP_CALL(SCIPcreateChild(scip, &childdiffer, 0.0, SCIPgetLocalTransEstimate(scip)));
+
+   // create and add the branching decisions to the children
+   char       cons_name[255];
+   SCIP_CONS* conssame;
+   SCIP_CONS* consdiffer;
+
+   SCIPsnprintf(cons_name, 255, "same_%d_%d", item1, item2);
+   SCIP_CALL(createConsSameDiff(scip, &conssame, cons_name, item1, item2, SAME, childsame, TRUE));
+
+   SCIPsnprintf(cons_name, 255, "differ_%d_%d", item1, item2);
+   SCIP_CALL(createConsSameDiff(scip, &consdiffer, cons_name, item1, item2, DIFFER, childdiffer, TRUE));
+
+   SCIP_CALL(SCIPaddConsNode(scip, childsame, conssame, NULL));
+   SCIP_CALL(SCIPaddConsNode(scip, childdiffer, consdiffer, NULL));
+
+   SCIP_CALL(SCIPreleaseCons(scip, &conssame));
+   SCIP_CALL(SCIPreleaseCons(scip, &consdiffer));
+
+   *result = SCIP_BRANCHED;
+
+   return SCIP_OKAY;
+}
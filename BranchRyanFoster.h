@@ -0,0 +1,37 @@
+// BranchRyanFoster.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief Ryan-Foster branching rule for the pattern model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @note Branching on a single pattern variable lambda_p destroys the structure of the pricing problem, as the pricer
+ * would generate the forbidden pattern again. Ryan and Foster instead branch on a pair of items (i, k): in the first
+ * child both items have to be packed into the same bin, in the second child they have to be packed into different
+ * bins. If the LP solution is fractional, there is a pair, for which the sum of the values of all patterns containing
+ * both items is fractional. The rule chooses the pair with the value closest to 0.5 and stores the decisions as
+ * same/differ constraints (see ConsSameDiff), which are respected by the pricer.
+ */
+class BranchRyanFoster : public ObjBranchrule
+{
+public:
+   // constructor
+   BranchRyanFoster(SCIP* scip, Instance* ins);
+
+   // destructor
+   virtual ~BranchRyanFoster() {}
+
+   // branching on a fractional LP solution
+   virtual SCIP_DECL_BRANCHEXECLP(scip_execlp);
+
+private:
+   Instance* _ins; // pointer to the instance
+};
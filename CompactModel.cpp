@@ -1,5 +1,10 @@
 // CompactModel.cpp  ???
 #include "CompactModel.h"
+#include "ConsBinPacking.h"
+#include "HeurRounding.h"
+#include "SepaBinPacking.h"
+
+#include <algorithm>
 #include <scip/scip_general.h>
 #include <scip/scip_prob.h>
 
@@ -8,17 +13,38 @@
  *
  * @param ins pointer to problem-instance
  *
+ * @param symmetryBreaking true: create X_ij only for j <= i and add the bin ordering constraints
+ *
+ * @param production true: do not generate names for the variables and constraints
+ *
+ * @param scip empty SCIP environment with the default plugins, which is borrowed by the model, nullptr: the model
+ * creates and frees its own environment
+ *
  * @note This code is a constructor for the CompactModel class. It creates a SCIP environment and sets the specific
  * parameters. It then creates and adds all variables to the model, including binary variables X_ij and Y_i for items i,
- * bins j. Finally, it adds all restrictions to the model and writes the final LP-model into a file.
+ * bins j. Finally, it adds all restrictions to the model. Every constraint is created by a single call from
+ * contiguous arrays of its variables and coefficients instead of adding the coefficients one by one. In production
+ * mode no names are generated, SCIP stores empty names. The LP-model is only written into a file on request (see
+ * writeLP()).
  */
-CompactModel::CompactModel(Instance* ins)
+CompactModel::CompactModel(Instance* ins, bool symmetryBreaking, bool production, SCIP* scip)
 {
-   _ins = ins; // initialize the private pointer variable to the instance object
-
-   // create a SCIP environment and load all defaults
-   SCIPcreate(&_scipCM);
-   SCIPincludeDefaultPlugins(_scipCM);
+   _ins              = ins; // initialize the private pointer variable to the instance object
+   _symmetryBreaking = symmetryBreaking;
+   _production       = production;
+   _modified         = false;
+   _cons_bin_packing = nullptr;
+   _removed.assign(_ins->_nbItems, false);
+
+   // create a SCIP environment and load all defaults, unless an environment is borrowed
+   _ownsSCIP = scip == nullptr;
+   if( _ownsSCIP )
+   {
+      SCIPcreate(&_scipCM);
+      SCIPincludeDefaultPlugins(_scipCM);
+   }
+   else
+      _scipCM = scip;
 
    // create an empty model
    SCIPcreateProbBasic(_scipCM, "Compact Model BPP");
@@ -29,8 +55,8 @@ CompactModel::CompactModel(Instance* ins)
    // call the created function set all optional SCIPParameters
    setSCIPParameters();
 
-   // create helping-dummy for the name of variables and constraints
-   char var_cons_name[255];
+   // create helping-dummy for the name of variables and constraints, it stays empty in production mode
+   char var_cons_name[255] = "";
 
    // #####################################################################################################################
    //  Create and add all variables
@@ -43,7 +69,8 @@ CompactModel::CompactModel(Instance* ins)
 
    for( int j = 0; j < _ins->_nbBins; ++j )
    {
-      SCIPsnprintf(var_cons_name, 255, "Y_%d", j); // set name for debugging
+      if( !_production )
+         SCIPsnprintf(var_cons_name, 255, "Y_%d", j); // set name for debugging
 
       SCIPcreateVarBasic(_scipCM,              //
                          &_var_Y[j],           // returns the address of the newly created variable
@@ -59,23 +86,28 @@ CompactModel::CompactModel(Instance* ins)
    // #####################################################################################################################
    //  binary variable X_ij
 
-   // set all dimensions for X_ij, with empty pointers
-   _var_X.resize(_ins->_nbItems); // first dimension of X_ij is equal to the amount of items in this instance
+   // compute the position of the first variable of every item: without symmetry breaking every item has _nbBins
+   // admissible bins, with symmetry breaking item i only has the bins 0, ..., i
+   _var_X_begin.resize(_ins->_nbItems + 1, 0);
 
    for( int i = 0; i < _ins->_nbItems; ++i )
    {
-      _var_X[i].resize(_ins->_nbItems,
-                       nullptr); // second dimension of X_ij is equal to the amount of bins in this instance
+      _var_X_begin[i + 1] = _var_X_begin[i] + (_symmetryBreaking ? min(i + 1, _ins->_nbBins) : _ins->_nbBins);
    }
-   // create and add the variable Y_ij to the model
+
+   // set the dimension of the flat array for X_ij, with empty pointers
+   _var_X.resize(_var_X_begin[_ins->_nbItems], nullptr);
+
+   // create and add the variable X_ij to the model
    for( int i = 0; i < _ins->_nbItems; ++i )
    {
-      for( int j = 0; j < _ins->_nbBins; ++j )
+      for( int j = 0; j < _var_X_begin[i + 1] - _var_X_begin[i]; ++j ) // all admissible bins of item i
       {
-         SCIPsnprintf(var_cons_name, 255, "X_%d_%d", i, j); // set name
+         if( !_production )
+            SCIPsnprintf(var_cons_name, 255, "X_%d_%d", i, j); // set name
 
          SCIPcreateVarBasic(_scipCM,
-                            &_var_X[i][j], // returns the address of the newly created variable
+                            &_var_X[_var_X_begin[i] + j], // returns the address of the newly created variable
                             var_cons_name, // name
                             0,             // lower bound
                             1,             // upper bound
@@ -83,7 +115,7 @@ CompactModel::CompactModel(Instance* ins)
                                // appear in the objective (1)
                             SCIP_VARTYPE_BINARY); // variable type
 
-         SCIPaddVar(_scipCM, _var_X[i][j]); // add var to scip-env
+         SCIPaddVar(_scipCM, _var_X[_var_X_begin[i] + j]); // add var to scip-env
       }
    }
    // #####################################################################################################################
@@ -101,23 +133,22 @@ CompactModel::CompactModel(Instance* ins)
 
    _cons_unique_assignment.resize(_ins->_nbItems, nullptr); // dimension is equal to the number of items in theinstance
 
+   // the variables X_ij of item i are contiguous in _var_X, so only the coefficients have to be prepared
+   vector<SCIP_Real> ones(_ins->_nbBins, 1);
+
    for( int i = 0; i < _ins->_nbItems; ++i )
    {
-      SCIPsnprintf(var_cons_name, 255, "unique_assignment_%d", i);
-
-      SCIPcreateConsBasicLinear(_scipCM,                     // scip
-                                &_cons_unique_assignment[i], // cons
-                                var_cons_name,               // name
-                                0,                           // nvar
-                                0,                           // vars
-                                0,                           // coeffs
-                                1,                           // lhs
-                                1);                          // rhs
-
-      for( int j = 0; j < _ins->_nbBins; ++j ) // sum over all bins j in J
-      {
-         SCIPaddCoefLinear(_scipCM, _cons_unique_assignment[i], _var_X[i][j], 1);
-      }
+      if( !_production )
+         SCIPsnprintf(var_cons_name, 255, "unique_assignment_%d", i);
+
+      SCIPcreateConsBasicLinear(_scipCM,                               // scip
+                                &_cons_unique_assignment[i],           // cons
+                                var_cons_name,                         // name
+                                _var_X_begin[i + 1] - _var_X_begin[i], // nvar: all admissible bins j in J
+                                &_var_X[_var_X_begin[i]],              // vars
+                                ones.data(),                           // coeffs
+                                1,                                     // lhs
+                                1);                                    // rhs
 
       SCIPaddCons(_scipCM, _cons_unique_assignment[i]);
    }
@@ -133,36 +164,73 @@ CompactModel::CompactModel(Instance* ins)
    _cons_capacity_and_linking.resize(_ins->_nbBins,
                                      nullptr); // dimension is equal to the number of bins in this instance
 
+   // arrays of the variables and coefficients of a single constraint, reused for every bin
+   vector<SCIP_VAR*> cons_vars;
+   vector<SCIP_Real> cons_coefs;
+   cons_vars.reserve(_ins->_nbItems + 1);
+   cons_coefs.reserve(_ins->_nbItems + 1);
+
    for( int j = 0; j < _ins->_nbBins; ++j )
    {
-      SCIPsnprintf(var_cons_name, 255, "capacity_and_linking_%i", j); // set constraint name for debugging
+      if( !_production )
+         SCIPsnprintf(var_cons_name, 255, "capacity_and_linking_%i", j); // set constraint name for debugging
+
+      cons_vars.clear();
+      cons_coefs.clear();
+
+      for( int i = 0; i < _ins->_nbItems; ++i ) // sum over all items i in I, which may be placed in bin j
+      {
+         if( getVarX(i, j) == nullptr )
+            continue;
+
+         cons_vars.push_back(getVarX(i, j));
+         cons_coefs.push_back(_ins->par_w[i]);
+      }
+      cons_vars.push_back(_var_Y[j]);
+      cons_coefs.push_back(-ins->par_b);
 
       SCIPcreateConsBasicLinear(_scipCM,                        // scip
                                 &_cons_capacity_and_linking[j], // cons
                                 var_cons_name,                  // name
-                                0,                              // number of variables
-                                0,                              // vars
-                                0,                              // coeffs
+                                (int) cons_vars.size(),         // number of variables
+                                cons_vars.data(),               // vars
+                                cons_coefs.data(),              // coeffs
                                 -SCIPinfinity(_scipCM),         // lhs
                                 0);                             // rhs
 
-      for( int i = 0; i < _ins->_nbItems; ++i ) // sum over all items i in I
-      {
-         SCIPaddCoefLinear(_scipCM,                       // scip-env
-                           _cons_capacity_and_linking[j], // constraint
-                           _var_X[i][j],                  // variable
-                           _ins->par_w[i]);               // coefficient
-      }
-      SCIPaddCoefLinear(_scipCM, _cons_capacity_and_linking[j], _var_Y[j], -ins->par_b);
       SCIPaddCons(_scipCM, _cons_capacity_and_linking[j]); // add constraint to the scip-env
    }
 
    // #####################################################################################################################
-   //  Generate LP file
-   // #####################################################################################################################
+   //  symmetry breaking: bin ordering constraints
+
+   // Y_j >= Y_{j+1} for all bins j in J without the last one
+   // is equal to:
+   // 0 <= Y_j - Y_{j+1} <= infty
 
-   // Generate a file to show the LP-Program, that is build. "FALSE" = we get our specific choosen names.
-   SCIPwriteOrigProblem(_scipCM, "compact_model_bpp.lp", "lp", FALSE);
+   if( _symmetryBreaking )
+   {
+      _cons_bin_ordering.resize(max(_ins->_nbBins - 1, 0), nullptr);
+
+      for( int j = 0; j + 1 < _ins->_nbBins; ++j )
+      {
+         if( !_production )
+            SCIPsnprintf(var_cons_name, 255, "bin_ordering_%i", j);
+
+         SCIP_Real ordering_coefs[2] = {1, -1};
+
+         SCIPcreateConsBasicLinear(_scipCM,                // scip
+                                   &_cons_bin_ordering[j], // cons
+                                   var_cons_name,          // name
+                                   2,                      // number of variables
+                                   &_var_Y[j],             // vars: Y_j and Y_{j+1}
+                                   ordering_coefs,         // coeffs
+                                   0,                      // lhs
+                                   SCIPinfinity(_scipCM)); // rhs
+
+         SCIPaddCons(_scipCM, _cons_bin_ordering[j]);
+      }
+   }
 }
 
 /**
@@ -199,18 +267,25 @@ CompactModel::~CompactModel()
       SCIPreleaseCons(_scipCM, &_cons_capacity_and_linking[j]);
    }
 
+   // release all bin ordering constraints (only created with symmetry breaking)
+   for( size_t j = 0; j < _cons_bin_ordering.size(); j++ )
+   {
+      SCIPreleaseCons(_scipCM, &_cons_bin_ordering[j]);
+   }
+
+   // release the global bin-packing constraint (only created on request)
+   if( _cons_bin_packing != nullptr )
+      SCIPreleaseCons(_scipCM, &_cons_bin_packing);
+
    // #####################################################################################################################
    //  release all variables
    // #####################################################################################################################
 
-   // release all X_ij - variables
+   // release all X_ij - variables, the flat array only contains the admissible ones
 
-   for( int i = 0; i < _ins->_nbItems; ++i ) // sum over all i in I
+   for( size_t k = 0; k < _var_X.size(); ++k )
    {
-      for( int j = 0; j < _ins->_nbBins; ++j ) // sum over all j in J
-      {
-         SCIPreleaseVar(_scipCM, &_var_X[i][j]);
-      }
+      SCIPreleaseVar(_scipCM, &_var_X[k]);
    }
 
    // release all Y_j - variables
@@ -222,8 +297,11 @@ CompactModel::~CompactModel()
    // #####################################################################################################################
    //  release SCIP object
    // #####################################################################################################################
-   //  At the end release the SCIP object itself
-   SCIPfree(&_scipCM);
+   //  At the end release the SCIP object itself, a borrowed environment only frees the problem and can be reused
+   if( _ownsSCIP )
+      SCIPfree(&_scipCM);
+   else
+      SCIPfreeProb(_scipCM);
 }
 
 /**
@@ -242,16 +320,564 @@ void CompactModel::setSCIPParameters()
    SCIPsetBoolParam(_scipCM, "display/lpinfo", FALSE); // default FALSE
 };
 
+/**
+ * @brief pass the packing of the heuristic to SCIP as a starting solution
+ *
+ * @param heur pointer to the heuristic, which has already been run
+ *
+ * @note This function creates a SCIP solution, in which X_ij = 1 for the bin j of every item i in the heuristic
+ * packing and Y_j = 1 for every used bin j, all other variables are 0. It has to be called before solve(). SCIP checks
+ * the solution at the beginning of the solving process, so the primal bound is known from the first node on. The
+ * number of bins of the model (_nbBins) must not be smaller than the number of bins used by the heuristic. The bins
+ * are relabeled in the order of their smallest item, so item i is always placed in a bin j <= i and the used bins are
+ * 0, ..., _nbBinsUsed - 1, which is feasible for the symmetry-broken formulation as well.
+ */
+void CompactModel::addStartSolution(Heuristic* heur)
+{
+   if( !heur->_feasible )
+      return;
+
+   addStartSolution(heur->_bin_of_item, heur->_nbBinsUsed);
+};
+
+/**
+ * @brief pass a packing to SCIP as a starting solution
+ *
+ * @param bin_of_item bin of every item, -1 for removed items
+ *
+ * @param nbBinsUsed number of bins of the packing, the bins are 0, ..., nbBinsUsed - 1
+ *
+ * @note The bins are relabeled in the order of their smallest item (see addStartSolution(Heuristic*)).
+ */
+void CompactModel::addStartSolution(const vector<int>& bin_of_item, int nbBinsUsed)
+{
+   if( nbBinsUsed > _ins->_nbBins )
+      return;
+
+   SCIP_Bool stored;
+
+   // relabel the bins in the order of their smallest item
+   vector<int> label(nbBinsUsed, -1);
+   int         nbLabels = 0;
+
+   SCIPcreateSol(_scipCM, &_sol, NULL);
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( bin_of_item[i] == -1 )
+         continue;
+
+      int& j = label[bin_of_item[i]];
+      if( j == -1 )
+         j = nbLabels++;
+
+      SCIPsetSolVal(_scipCM, _sol, getVarX(i, j), 1);
+   }
+
+   for( int j = 0; j < nbLabels; ++j )
+   {
+      SCIPsetSolVal(_scipCM, _sol, _var_Y[j], 1);
+   }
+
+   SCIPaddSol(_scipCM, _sol, &stored);
+   SCIPfreeSol(_scipCM, &_sol);
+};
+
+/**
+ * @brief store the best packing and free the transformed problem
+ *
+ * @note The original problem can only be changed in the problem stage. If the model has been solved, the bin of every
+ * item in the best solution is stored for the warm start of the next solve, then the transformed problem is freed.
+ * The variables and constraints of the original problem are kept.
+ */
+void CompactModel::beginModification()
+{
+   _modified = true;
+
+   if( SCIPgetStage(_scipCM) <= SCIP_STAGE_PROBLEM )
+      return;
+
+   vector<int> packing = getPacking();
+   if( !packing.empty() )
+      _packing = packing;
+
+   SCIPfreeTransform(_scipCM);
+}
+
+/**
+ * @brief add a new item to the model
+ *
+ * @param weight weight of the new item
+ *
+ * @return index of the new item
+ *
+ * @note The item is appended to the instance. Its variables X_ij are appended to the flat array, its unique
+ * assignment constraint is created and its weight is added to the capacity constraints of all admissible bins.
+ */
+int CompactModel::addItem(double weight)
+{
+   beginModification();
+
+   int i = _ins->_nbItems;
+   _ins->par_w.push_back(weight);
+   _ins->_nbItems++;
+   _ins->setIntegral();
+   _removed.push_back(false);
+
+   char var_cons_name[255] = "";
+
+   int nbAdmissible = _symmetryBreaking ? min(i + 1, _ins->_nbBins) : _ins->_nbBins;
+   _var_X_begin.push_back(_var_X_begin[i] + nbAdmissible);
+   _var_X.resize(_var_X_begin[i + 1], nullptr);
+
+   for( int j = 0; j < nbAdmissible; ++j )
+   {
+      if( !_production )
+         SCIPsnprintf(var_cons_name, 255, "X_%d_%d", i, j);
+
+      SCIPcreateVarBasic(_scipCM, &_var_X[_var_X_begin[i] + j], var_cons_name, 0, 1, 0, SCIP_VARTYPE_BINARY);
+      SCIPaddVar(_scipCM, _var_X[_var_X_begin[i] + j]);
+
+      SCIPaddCoefLinear(_scipCM, _cons_capacity_and_linking[j], _var_X[_var_X_begin[i] + j], weight);
+   }
+
+   if( !_production )
+      SCIPsnprintf(var_cons_name, 255, "unique_assignment_%d", i);
+
+   vector<SCIP_Real> ones(nbAdmissible, 1);
+   _cons_unique_assignment.push_back(nullptr);
+   SCIPcreateConsBasicLinear(_scipCM,
+                             &_cons_unique_assignment[i],
+                             var_cons_name,
+                             nbAdmissible,
+                             &_var_X[_var_X_begin[i]],
+                             ones.data(),
+                             1,
+                             1);
+   SCIPaddCons(_scipCM, _cons_unique_assignment[i]);
+
+   return i;
+}
+
+/**
+ * @brief remove item i from the model
+ *
+ * @param i item i \in I, which has not been removed yet
+ *
+ * @return true, if the item is removed, false if it is unknown or has already been removed
+ *
+ * @note The indices of the other items must not change, so the item is not erased: its unique assignment constraint
+ * is deleted from the problem and its variables X_ij are fixed to 0. The instance is not changed, the removed state is
+ * only kept in the model (_removed).
+ */
+bool CompactModel::removeItem(int i)
+{
+   if( i < 0 || i >= _ins->_nbItems || _removed[i] )
+      return false;
+
+   beginModification();
+
+   _removed[i] = true;
+
+   SCIPdelCons(_scipCM, _cons_unique_assignment[i]);
+   for( int k = _var_X_begin[i]; k < _var_X_begin[i + 1]; ++k )
+   {
+      SCIPchgVarUb(_scipCM, _var_X[k], 0);
+   }
+
+   if( i < (int) _packing.size() )
+      _packing[i] = -1;
+
+   return true;
+}
+
+/**
+ * @brief change the weight of item i
+ *
+ * @param i item i \in I, which has not been removed
+ *
+ * @param weight new weight
+ *
+ * @return true, if the weight is changed, false if the item is unknown or has been removed
+ *
+ * @note Only the coefficients of X_ij in the capacity constraints are changed.
+ */
+bool CompactModel::changeWeight(int i, double weight)
+{
+   if( i < 0 || i >= _ins->_nbItems || _removed[i] )
+      return false;
+
+   beginModification();
+
+   _ins->par_w[i] = weight;
+   _ins->setIntegral();
+
+   for( int j = 0; j < _var_X_begin[i + 1] - _var_X_begin[i]; ++j )
+   {
+      SCIPchgCoefLinear(_scipCM, _cons_capacity_and_linking[j], getVarX(i, j), weight);
+   }
+
+   return true;
+}
+
+/**
+ * @brief add a new bin j = _nbBins
+ *
+ * @note The flat array of X_ij is rebuilt, as every item gets a new variable in the middle of the array: the existing
+ * variables are only moved, not created again. The new X_ij are added to the unique assignment constraints, the new
+ * bin gets its capacity constraint and, with symmetry breaking, its bin ordering constraint. The X_ij of removed items
+ * are fixed to 0.
+ */
+void CompactModel::addBin()
+{
+   int j = _ins->_nbBins;
+
+   char var_cons_name[255] = "";
+
+   if( !_production )
+      SCIPsnprintf(var_cons_name, 255, "Y_%d", j);
+
+   _var_Y.push_back(nullptr);
+   SCIPcreateVarBasic(_scipCM, &_var_Y[j], var_cons_name, 0, 1, 1, SCIP_VARTYPE_BINARY);
+   SCIPaddVar(_scipCM, _var_Y[j]);
+
+   // rebuild the flat array: item i gets the bin j, if it is admissible
+   vector<SCIP_VAR*> var_X;
+   vector<int>       var_X_begin(_ins->_nbItems + 1, 0);
+   var_X.reserve(_var_X.size() + _ins->_nbItems);
+
+   vector<SCIP_VAR*> cons_vars;
+   vector<SCIP_Real> cons_coefs;
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      var_X.insert(var_X.end(), _var_X.begin() + _var_X_begin[i], _var_X.begin() + _var_X_begin[i + 1]);
+
+      if( !_symmetryBreaking || j <= i )
+      {
+         if( !_production )
+            SCIPsnprintf(var_cons_name, 255, "X_%d_%d", i, j);
+
+         SCIP_VAR* var;
+         SCIPcreateVarBasic(_scipCM, &var, var_cons_name, 0, _removed[i] ? 0 : 1, 0, SCIP_VARTYPE_BINARY);
+         SCIPaddVar(_scipCM, var);
+         var_X.push_back(var);
+
+         if( !_removed[i] )
+            SCIPaddCoefLinear(_scipCM, _cons_unique_assignment[i], var, 1);
+
+         cons_vars.push_back(var);
+         cons_coefs.push_back(_ins->par_w[i]);
+      }
+
+      var_X_begin[i + 1] = (int) var_X.size();
+   }
+
+   _var_X       = var_X;
+   _var_X_begin = var_X_begin;
+
+   // capacity and linking constraint of the new bin
+   cons_vars.push_back(_var_Y[j]);
+   cons_coefs.push_back(-_ins->par_b);
+
+   if( !_production )
+      SCIPsnprintf(var_cons_name, 255, "capacity_and_linking_%i", j);
+
+   _cons_capacity_and_linking.push_back(nullptr);
+   SCIPcreateConsBasicLinear(_scipCM,
+                             &_cons_capacity_and_linking[j],
+                             var_cons_name,
+                             (int) cons_vars.size(),
+                             cons_vars.data(),
+                             cons_coefs.data(),
+                             -SCIPinfinity(_scipCM),
+                             0);
+   SCIPaddCons(_scipCM, _cons_capacity_and_linking[j]);
+
+   // bin ordering constraint Y_{j-1} >= Y_j
+   if( _symmetryBreaking && j > 0 )
+   {
+      if( !_production )
+         SCIPsnprintf(var_cons_name, 255, "bin_ordering_%i", j - 1);
+
+      SCIP_Real ordering_coefs[2] = {1, -1};
+
+      _cons_bin_ordering.push_back(nullptr);
+      SCIPcreateConsBasicLinear(_scipCM,
+                                &_cons_bin_ordering.back(),
+                                var_cons_name,
+                                2,
+                                &_var_Y[j - 1],
+                                ordering_coefs,
+                                0,
+                                SCIPinfinity(_scipCM));
+      SCIPaddCons(_scipCM, _cons_bin_ordering.back());
+   }
+
+   _ins->_nbBins++;
+}
+
+/**
+ * @brief repair the stored packing for the changed model and pass it as a starting solution
+ *
+ * @note Every item keeps its bin of the last packing, as long as the bin does not exceed the capacity with the
+ * current weights; otherwise the heaviest items are taken out of the bin. New and taken out items are packed by
+ * First-Fit-Decreasing into the bins of the packing or into new bins. If the repaired packing needs more bins than
+ * the model has, bins are added. So the model always contains a feasible packing, which is only slightly worse than
+ * the last one, and SCIP starts with a good primal bound.
+ */
+void CompactModel::addWarmStart()
+{
+   vector<int> bin_of_item = _packing;
+   bin_of_item.resize(_ins->_nbItems, -1);
+
+   int nbBinsUsed = 0;
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      nbBinsUsed = max(nbBinsUsed, bin_of_item[i] + 1);
+   }
+
+   // items of every bin by decreasing weight
+   vector<vector<int>> items(nbBinsUsed);
+   vector<double>      load(nbBinsUsed, 0);
+   vector<int>         unpacked;
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( _removed[i] )
+         continue;
+
+      if( bin_of_item[i] == -1 )
+         unpacked.push_back(i);
+      else
+         items[bin_of_item[i]].push_back(i);
+   }
+
+   for( int j = 0; j < nbBinsUsed; ++j )
+   {
+      sort(items[j].begin(), items[j].end(), [this](int a, int b) { return _ins->par_w[a] > _ins->par_w[b]; });
+      for( int i : items[j] )
+      {
+         load[j] += _ins->par_w[i];
+      }
+
+      // take out the heaviest items, until the bin fits
+      for( size_t k = 0; k < items[j].size() && load[j] > _ins->par_b + 1e-9; ++k )
+      {
+         int i = items[j][k];
+         load[j] -= _ins->par_w[i];
+         bin_of_item[i] = -1;
+         unpacked.push_back(i);
+      }
+   }
+
+   // First-Fit-Decreasing for the unpacked items
+   stable_sort(unpacked.begin(), unpacked.end(), [this](int a, int b) { return _ins->par_w[a] > _ins->par_w[b]; });
+   for( int i : unpacked )
+   {
+      if( _ins->par_w[i] > _ins->par_b )
+         return; // infeasible, there is no starting solution
+
+      int j = 0;
+      while( j < (int) load.size() && load[j] + _ins->par_w[i] > _ins->par_b + 1e-9 )
+      {
+         ++j;
+      }
+      if( j == (int) load.size() )
+         load.push_back(0);
+
+      load[j] += _ins->par_w[i];
+      bin_of_item[i] = j;
+   }
+
+   // bins, which became empty, are dropped by the relabeling in addStartSolution()
+   while( _ins->_nbBins < (int) load.size() )
+   {
+      addBin();
+   }
+
+   addStartSolution(bin_of_item, (int) load.size());
+}
+
+/**
+ * @brief write the LP-model into a file
+ *
+ * @param fileName path of the LP file, e.g. "compact_model_bpp.lp"
+ *
+ * @note Generate a file to show the LP-Program, that is build. Without production mode our specific chosen names are
+ * used, in production mode there are no names, so SCIP generates generic names.
+ */
+void CompactModel::writeLP(const string& fileName)
+{
+   SCIPwriteOrigProblem(_scipCM, fileName.c_str(), "lp", _production ? TRUE : FALSE);
+};
+
+/**
+ * @brief get the variable X_ij
+ *
+ * @param i item i \in I
+ *
+ * @param j bin j \in J
+ *
+ * @return the variable X_ij, nullptr if item i may not be placed in bin j
+ */
+SCIP_VAR* CompactModel::getVarX(int i, int j)
+{
+   if( j >= _var_X_begin[i + 1] - _var_X_begin[i] )
+      return nullptr;
+
+   return _var_X[_var_X_begin[i] + j];
+};
+
+/**
+ * @brief get the best packing
+ *
+ * @return the bin of every item in the best solution of SCIP, -1 for removed items, empty if there is no solution
+ *
+ * @note The packing is only available after solving, as long as the transformed problem has not been freed.
+ */
+vector<int> CompactModel::getPacking()
+{
+   if( SCIPgetStage(_scipCM) <= SCIP_STAGE_PROBLEM || SCIPgetBestSol(_scipCM) == NULL )
+      return {};
+
+   SCIP_SOL*   best = SCIPgetBestSol(_scipCM);
+   vector<int> packing(_ins->_nbItems, -1);
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      for( int j = 0; j < _var_X_begin[i + 1] - _var_X_begin[i] && !_removed[i]; ++j )
+      {
+         if( SCIPgetSolVal(_scipCM, best, getVarX(i, j)) > 0.5 )
+            packing[i] = j;
+      }
+   }
+
+   return packing;
+}
+
+/**
+ * @brief pass a packing found elsewhere to SCIP while solving
+ *
+ * @param bin_of_item bin of every item, -1 for removed items, the bins may have arbitrary labels
+ *
+ * @param heur heuristic, which has found the packing, or NULL
+ *
+ * @return true, if SCIP has stored the packing as a new solution
+ *
+ * @note As in addStartSolution(), the bins are relabeled in the order of their smallest item, so the packing is also
+ * feasible for the symmetry-broken formulation. The solution is checked by SCIPtrySolFree(), so it can be passed in any
+ * stage after the transformation, e.g. from a primal heuristic. It is created with SCIPcreateOrigSol(), because its
+ * values are set on the original variables, whose transformed variables presolving may have multi-aggregated.
+ */
+bool CompactModel::tryPacking(const vector<int>& bin_of_item, SCIP_HEUR* heur)
+{
+   if( bin_of_item.empty() || (int) bin_of_item.size() != _ins->_nbItems )
+      return false;
+
+   int nbLabels = 0;
+   int maxBin   = *max_element(bin_of_item.begin(), bin_of_item.end());
+   if( maxBin < 0 )
+      return false;
+
+   vector<int> label(maxBin + 1, -1);
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( bin_of_item[i] != -1 && label[bin_of_item[i]] == -1 )
+         label[bin_of_item[i]] = nbLabels++;
+   }
+   if( nbLabels > _ins->_nbBins )
+      return false;
+
+   SCIP_SOL* sol;
+   SCIPcreateOrigSol(_scipCM, &sol, heur);
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( bin_of_item[i] != -1 )
+         SCIPsetSolVal(_scipCM, sol, getVarX(i, label[bin_of_item[i]]), 1);
+   }
+
+   for( int j = 0; j < nbLabels; ++j )
+   {
+      SCIPsetSolVal(_scipCM, sol, _var_Y[j], 1);
+   }
+
+   SCIP_Bool stored;
+   SCIPtrySolFree(_scipCM, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored);
+
+   return stored;
+}
+
+/**
+ * @brief add the global bin-packing constraint
+ *
+ * @note The constraint handler gets references to the variable vectors of the model, so it also sees the variables of
+ * items and bins added later. The linear capacity constraints are kept: they define the LP relaxation and check the
+ * packings, the global constraint only propagates. It is added at most once, before the first solve, and not into a
+ * borrowed environment, which outlives the model.
+ */
+void CompactModel::addBinPackingConstraint()
+{
+   if( _cons_bin_packing != nullptr || !_ownsSCIP )
+      return;
+
+   SCIPincludeObjConshdlr(_scipCM, new ConsBinPacking(_scipCM, _ins, _var_X, _var_X_begin, _var_Y), TRUE);
+
+   createConsBinPacking(_scipCM, &_cons_bin_packing, _production ? "" : "bin_packing");
+   SCIPaddCons(_scipCM, _cons_bin_packing);
+}
+
+/**
+ * @brief add the LP rounding heuristic
+ *
+ * @param freq frequency of the calls (depth in the tree), 0: only at the root node, negative: the heuristic is not added
+ *
+ * @note As the constraint handler, the heuristic gets references to the variable vectors of the model. It is added at
+ * most once, before the first solve, and not into a borrowed environment.
+ */
+void CompactModel::addRoundingHeuristic(int freq)
+{
+   if( freq < 0 || !_ownsSCIP || SCIPfindHeur(_scipCM, "bprounding") != nullptr )
+      return;
+
+   SCIPincludeObjHeur(_scipCM, new HeurRounding(_scipCM, _ins, _var_X, _var_X_begin, _var_Y, freq), TRUE);
+}
+
+/**
+ * @brief add the separator of problem-specific cuts
+ *
+ * @param freq frequency of the calls (depth in the tree), 0: only at the root node, negative: the separator is not added
+ *
+ * @note The separator gets references to the variable vectors of the model. It is added at most once and not into a
+ * borrowed environment.
+ */
+void CompactModel::addSeparator(int freq)
+{
+   if( freq < 0 || !_ownsSCIP || SCIPfindSepa(_scipCM, "binpacking") != nullptr )
+      return;
+
+   SCIPincludeObjSepa(_scipCM, new SepaBinPacking(_scipCM, _ins, _var_X, _var_X_begin, _var_Y, freq), TRUE);
+}
+
 /**
  * @brief solve the compact model
  *
  * @note This function solves the compact model using SCIPsolve. It prints a message to the console indicating that it
- * is starting to solve the compact model.
+ * is starting to solve the compact model. The message is printed by the message handler of SCIP, so it is suppressed
+ * together with the SCIP output, if the message handler is set quiet.
  */
 void CompactModel::solve()
 {
-   cout << "___________________________________________________________________________________________\n";
-   cout << "start Solving compact Model: \n";
+   SCIPinfoMessage(_scipCM,
+                   NULL,
+                   "___________________________________________________________________________________________\n");
+   SCIPinfoMessage(_scipCM, NULL, "start Solving compact Model: \n");
+
+   if( _modified )
+   {
+      addWarmStart();
+      _modified = false;
+   }
+
    SCIPsolve(_scipCM);
 };
 
@@ -1,6 +1,7 @@
 // CompactModel.h
 #pragma once
 
+#include "Heuristic.h"
 #include "Instance.h"
 
 /* scip includes */
@@ -31,13 +32,31 @@ using namespace scip;
  * The constraints include unique assignment constraints (every item i \in I is packed in exactly one bin) and capacity
  * and linking constraints (for every bin the sum of the weights of the packed items is less or equal to the bin
  * capacity b, also it ensures that variable Y_j = 0 implies X_ij = 0 for every item i and bin j).
+ * With symmetry breaking, item i may only be placed in bins j <= i and the bins are used in order (Y_j >= Y_{j+1}).
+ * Every packing can be relabeled to fulfill both restrictions, but most permutations of the bins of a packing are
+ * cut off. Only the admissible X_ij are created. They are stored item by item in a flat array: the admissible bins of
+ * item i are 0, ..., _var_X_begin[i + 1] - _var_X_begin[i] - 1.
+ * In production mode, the names of the variables and constraints are not generated, which saves most of the time to
+ * build a large model.
+ * The model can be changed incrementally after solving (addItem(), removeItem(), changeWeight()): the transformed
+ * problem is freed and the original SCIP problem is changed in place, no variable or constraint is created again. A
+ * removed item keeps its weight in the instance, the model and its plugins recognize it by its variables X_ij, which
+ * are all fixed to 0. The best packing of the last solve is kept and repaired, and passed as starting solution to the
+ * next solve. Bins are added, if the repaired packing needs more bins than the model has.
+ * A SCIP environment can be borrowed from a pool (see SolverService): the model then only creates its problem in it,
+ * and the destructor frees the problem with SCIPfreeProb() instead of the environment, so the plugins are included
+ * only once per environment. The model must not include own plugins into a borrowed environment.
+ * Optionally, a global bin-packing constraint propagates the loads of all bins together (addBinPackingConstraint()).
+ * An LP rounding heuristic turns the LP solutions of the nodes into packings (addRoundingHeuristic()).
+ * A separator strengthens the LP relaxation by linking, cover and dual feasible function cuts (addSeparator()).
  */
 class CompactModel
 {
 
 public:
-   // constructor
-   CompactModel(Instance* ins);
+   // constructor, symmetryBreaking: item i only in bins j <= i and Y_j >= Y_{j+1}, production: no names, scip: empty
+   // environment with the default plugins, which is only borrowed by the model, nullptr: the model creates its own
+   CompactModel(Instance* ins, bool symmetryBreaking = false, bool production = false, SCIP* scip = nullptr);
 
    // destructor
    ~CompactModel();
@@ -51,15 +70,75 @@ public:
    // set all optional SCIP-Parameters
    void setSCIPParameters();
 
+   // pass the packing of the heuristic to SCIP as a starting solution
+   void addStartSolution(Heuristic* heur);
+
+   // add a new item to the model, returns its index
+   int addItem(double weight);
+
+   // remove item i from the model, its index stays reserved, false if the item is unknown or already removed
+   bool removeItem(int i);
+
+   // change the weight of item i, false if the item is unknown or removed
+   bool changeWeight(int i, double weight);
+
+   // returns the scip environment, e.g. to change parameters or to read the statistics after solving
+   SCIP* getSCIP() { return _scipCM; }
+
+   // write the LP-model into a file
+   void writeLP(const string& fileName);
+
+   // returns X_ij, nullptr if item i may not be placed in bin j
+   SCIP_VAR* getVarX(int i, int j);
+
+   // returns the bin of every item in the best solution, -1 for removed items, empty if there is no solution
+   vector<int> getPacking();
+
+   // pass a packing found elsewhere to SCIP while solving, e.g. from a heuristic, true if SCIP stores it
+   bool tryPacking(const vector<int>& bin_of_item, SCIP_HEUR* heur);
+
+   // add the global bin-packing constraint, which propagates all bins together (see ConsBinPacking)
+   void addBinPackingConstraint();
+
+   // add the LP rounding heuristic, which is called every freq-th depth of the tree (see HeurRounding)
+   void addRoundingHeuristic(int freq);
+
+   // add the separator of problem-specific cuts, which is called every freq-th depth of the tree (see SepaBinPacking)
+   void addSeparator(int freq);
+
 private:
-   SCIP*     _scipCM; // pointer to the scip environment for the compact model
-   SCIP_SOL* _sol;    // pointer to the solution of the compact model
+   // pass a packing to SCIP as a starting solution, the bins are relabeled in the order of their smallest item
+   void addStartSolution(const vector<int>& bin_of_item, int nbBinsUsed);
+
+   // store the best packing and free the transformed problem, so the original problem can be changed
+   void beginModification();
+
+   // repair the stored packing for the changed model and pass it as a starting solution
+   void addWarmStart();
+
+   // add a new bin j = _nbBins with its variables and constraints
+   void addBin();
+
+   SCIP*     _scipCM;   // pointer to the scip environment for the compact model
+   SCIP_SOL* _sol;      // pointer to the solution of the compact model
+   bool      _ownsSCIP; // true, if the model has created the environment and frees it, false: only the problem is freed
 
    Instance* _ins; // pointer to the instance
 
+   bool _symmetryBreaking; // true, if the symmetry-broken formulation is used
+   bool _production;       // true, if no names are generated for the variables and constraints
+
+   // incremental changes
+   bool         _modified; // true, if the model has been changed since the last solve
+   vector<bool> _removed;  // true for every removed item, dimension: number of items
+   vector<int>  _packing;  // bin of every item in the best packing of the last solve, -1 if unknown
+
    // variables
-   vector<vector<SCIP_VAR*>> _var_X; // X_ij: =1, if item i is placed in bin j
-   vector<SCIP_VAR*>         _var_Y; // Y_i:  =1, if bin i is used
+   vector<SCIP_VAR*> _var_X;       // X_ij: =1, if item i is placed in bin j, only the admissible X_ij are stored,
+                                   // X_ij is at position _var_X_begin[i] + j
+   vector<int>       _var_X_begin; // first position of the variables of item i in _var_X
+                                   // dimension: number of items + 1
+   vector<SCIP_VAR*> _var_Y;       // Y_i:  =1, if bin i is used
 
    // constraints
    vector<SCIP_CONS*> _cons_capacity_and_linking; // capacity and linking constraint for every bin: bin capacity is
@@ -68,4 +147,7 @@ private:
    vector<SCIP_CONS*> _cons_unique_assignment;    // unique assignment constraint: every item i is placed in exactly one
                                                   // bin j
                                                   // dimension: number of items
+   vector<SCIP_CONS*> _cons_bin_ordering;         // bin ordering constraint: bin j + 1 is only used, if bin j is used
+                                                  // dimension: number of bins - 1, empty without symmetry breaking
+   SCIP_CONS*         _cons_bin_packing;          // global bin-packing constraint, nullptr if it is not added
 };
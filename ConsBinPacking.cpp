@@ -0,0 +1,437 @@
+// ConsBinPacking.cpp
+#include "ConsBinPacking.h"
+#include "LowerBound.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Construct a new ConsBinPacking:: ConsBinPacking object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param ins pointer to the instance
+ *
+ * @param var_X, var_X_begin, var_Y variables of the compact model, the vectors are owned by the model and may grow
+ * between two solves (CompactModel::addItem(), CompactModel::addBin())
+ *
+ * @note The constraint handler only propagates, it never separates, enforces or checks (see ConsSameDiff).
+ */
+ConsBinPacking::ConsBinPacking(SCIP*                    scip,
+                               Instance*                ins,
+                               const vector<SCIP_VAR*>& var_X,
+                               const vector<int>&       var_X_begin,
+                               const vector<SCIP_VAR*>& var_Y)
+    : ObjConshdlr(scip,
+                  "binpacking",                               // name
+                  "global bin-packing constraint",            // description
+                  0,                                          // priority for separation
+                  0,                                          // priority for constraint enforcing
+                  9999999,                                    // priority for checking feasibility
+                  -1,                                         // frequency for separating cuts
+                  1,                                          // frequency for propagating domains
+                  1,                                          // frequency for using all instead of only useful conss
+                  0,                                          // maximal number of presolving rounds
+                  FALSE,                                      // delay separation
+                  FALSE,                                      // delay propagation
+                  TRUE,                                       // only call the handler if constraints are present
+                  SCIP_PROPTIMING_BEFORELP,                   // propagation timing
+                  SCIP_PRESOLTIMING_FAST),                    // presolving timing
+      _var_X(var_X),
+      _var_X_begin(var_X_begin),
+      _var_Y(var_Y)
+{
+   _ins           = ins;
+   _nbFixings     = 0;
+   _nbCutoffs     = 0;
+   _maxRounds     = 5;
+   _maxDPCapacity = 100000;
+}
+
+/**
+ * @brief create the global bin-packing constraint
+ *
+ * @note The constraint has no data, the constraint handler knows the variables of the model. It is only propagated.
+ */
+SCIP_RETCODE createConsBinPacking(SCIP* scip, SCIP_CONS** cons, const char* name)
+{
+   SCIP_CONSHDLR* conshdlr = SCIPfindConshdlr(scip, "binpacking");
+   if( conshdlr == NULL )
+   {
+      SCIPerrorMessage("binpacking constraint handler not found\n");
+      return SCIP_PLUGINNOTFOUND;
+   }
+
+   SCIP_CALL(SCIPcreateCons(scip,
+                            cons,
+                            name,
+                            conshdlr,
+                            NULL,   // no constraint data
+                            FALSE,  // initial
+                            FALSE,  // separate
+                            FALSE,  // enforce
+                            FALSE,  // check
+                            TRUE,   // propagate
+                            FALSE,  // local
+                            FALSE,  // modifiable
+                            FALSE,  // dynamic
+                            FALSE,  // removable
+                            FALSE)); // stickingatnode
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief fix a binary variable
+ */
+SCIP_RETCODE ConsBinPacking::fix(SCIP* scip, SCIP_VAR* var, double value, int* nfixedvars, SCIP_Bool* cutoff)
+{
+   SCIP_Bool infeasible;
+   SCIP_Bool fixed;
+
+   SCIP_CALL(SCIPfixVar(scip, var, value, &infeasible, &fixed));
+
+   if( infeasible )
+      *cutoff = TRUE;
+   else if( fixed )
+      ++(*nfixedvars);
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief propagate the constraint
+ *
+ * @param weight weight of every item, the integral weights of the instance or the doubles
+ *
+ * @param capacity capacity of a bin
+ *
+ * @note All comparisons of loads use fits(), so they are exact for integral weights and have a small tolerance for
+ * fractional weights. The loads of a round are computed from the local bounds at the start of the round; variables
+ * fixed during the round only make the values of the round weaker, never wrong.
+ */
+template <typename W>
+SCIP_RETCODE ConsBinPacking::propagate(SCIP* scip, const vector<W>& weight, W capacity, int* nfixedvars,
+                                       SCIP_Bool* cutoff)
+{
+   int n = _ins->_nbItems;
+   int m = (int) _trans_Y.size();
+
+   W                   total = 0;
+   vector<W>           required(m), possible(m), minLoad(m), maxLoad(m);
+   vector<vector<int>> candidates(m); // items, which may still be packed into every bin
+   vector<bool>        packed(n);
+
+   // removed items have all their variables fixed to 0 (see CompactModel::removeItem())
+   vector<bool> removed(n, true);
+   for( int i = 0; i < n; ++i )
+   {
+      for( int k = _var_X_begin[i]; k < _var_X_begin[i + 1] && removed[i]; ++k )
+      {
+         removed[i] = SCIPvarGetUbGlobal(_var_X[k]) < 0.5;
+      }
+      if( !removed[i] )
+         total += weight[i];
+   }
+
+   for( int round = 0; round < _maxRounds && !(*cutoff); ++round )
+   {
+      int nfixedBefore = *nfixedvars;
+
+      // #################################################################################################################
+      //  loads of the bins in the current node
+      // #################################################################################################################
+
+      fill(required.begin(), required.end(), W(0));
+      fill(possible.begin(), possible.end(), W(0));
+      fill(packed.begin(), packed.end(), false);
+      for( auto& c : candidates )
+      {
+         c.clear();
+      }
+
+      for( int i = 0; i < n; ++i )
+      {
+         for( int j = 0; j < _var_X_begin[i + 1] - _var_X_begin[i]; ++j )
+         {
+            SCIP_VAR* var = _trans_X[_var_X_begin[i] + j];
+            if( SCIPvarGetLbLocal(var) > 0.5 )
+            {
+               required[j] += weight[i];
+               packed[i] = true;
+            }
+            else if( SCIPvarGetUbLocal(var) > 0.5 )
+            {
+               possible[j] += weight[i];
+               candidates[j].push_back(i);
+            }
+         }
+      }
+
+      W sumMaxLoad = 0;
+      for( int j = 0; j < m; ++j )
+      {
+         possible[j] += required[j];
+         maxLoad[j] = SCIPvarGetUbLocal(_trans_Y[j]) < 0.5 ? W(0) : min(capacity, possible[j]);
+         sumMaxLoad += maxLoad[j];
+      }
+
+      // the other bins can take at most their maximal loads, the rest has to be packed into bin j
+      for( int j = 0; j < m; ++j )
+      {
+         minLoad[j] = max(required[j], total - (sumMaxLoad - maxLoad[j]));
+      }
+
+      // #################################################################################################################
+      //  knapsack reasoning: the load has to be a subset sum of the candidates
+      // #################################################################################################################
+
+      if constexpr( is_integral<W>::value )
+      {
+         for( int j = 0; j < m && capacity <= _maxDPCapacity; ++j )
+         {
+            W low  = max(minLoad[j] - required[j], W(0));
+            W high = maxLoad[j] - required[j];
+            if( high < low || candidates[j].empty() )
+               continue; // the infeasibility is detected below
+
+            // bit s is set, if a subset of the candidates has the weight s <= high
+            W                nbWords = high / 64 + 1;
+            vector<uint64_t> reachable(nbWords, 0);
+            reachable[0] = 1;
+            for( int i : candidates[j] )
+            {
+               W w = weight[i];
+               if( w > high )
+                  continue;
+
+               W   shiftWords = w / 64;
+               int shiftBits  = (int) (w % 64);
+               for( W k = nbWords - 1; k >= shiftWords; --k )
+               {
+                  uint64_t bits = reachable[k - shiftWords] << shiftBits;
+                  if( shiftBits > 0 && k - shiftWords - 1 >= 0 )
+                     bits |= reachable[k - shiftWords - 1] >> (64 - shiftBits);
+                  reachable[k] |= bits;
+               }
+            }
+
+            auto isReachable = [&reachable](W s) { return (reachable[s / 64] >> (s % 64) & 1) != 0; };
+
+            W lowest = low;
+            while( lowest <= high && !isReachable(lowest) )
+            {
+               ++lowest;
+            }
+            if( lowest > high )
+            {
+               *cutoff = TRUE;
+               break;
+            }
+
+            W highest = high;
+            while( !isReachable(highest) )
+            {
+               --highest;
+            }
+
+            minLoad[j] = required[j] + lowest;
+            maxLoad[j] = required[j] + highest;
+         }
+      }
+
+      // #################################################################################################################
+      //  fix the variables
+      // #################################################################################################################
+
+      for( int j = 0; j < m && !(*cutoff); ++j )
+      {
+         // no load in [minLoad_j, maxLoad_j]
+         if( !fits(minLoad[j], W(0), maxLoad[j]) )
+         {
+            *cutoff = TRUE;
+            break;
+         }
+
+         // a bin with a positive load is used
+         if( !fits(W(0), minLoad[j], W(0)) && SCIPvarGetLbLocal(_trans_Y[j]) < 0.5 )
+            SCIP_CALL(fix(scip, _trans_Y[j], 1.0, nfixedvars, cutoff));
+
+         for( size_t c = 0; c < candidates[j].size() && !(*cutoff); ++c )
+         {
+            int i = candidates[j][c];
+            if( packed[i] )
+               continue; // fixed to another bin in this round
+
+            if( !fits(required[j], weight[i], maxLoad[j]) )
+               SCIP_CALL(fix(scip, _trans_X[_var_X_begin[i] + j], 0.0, nfixedvars, cutoff));
+            else if( !fits(minLoad[j], weight[i], possible[j]) )
+            {
+               SCIP_CALL(fix(scip, _trans_X[_var_X_begin[i] + j], 1.0, nfixedvars, cutoff));
+               packed[i] = true;
+            }
+         }
+      }
+
+      if( *nfixedvars == nfixedBefore )
+         break;
+   }
+
+   if( *cutoff )
+      return SCIP_OKAY;
+
+   // ###################################################################################################################
+   //  bin count: merge the items of every bin into one item, items fixed in the last round are left out (relaxation)
+   // ###################################################################################################################
+
+   int available = 0;
+   for( int j = 0; j < m; ++j )
+   {
+      if( SCIPvarGetUbLocal(_trans_Y[j]) > 0.5 )
+         ++available;
+   }
+
+   long long bound;
+   if constexpr( is_integral<W>::value )
+   {
+      vector<long long> items;
+      for( int j = 0; j < m; ++j )
+      {
+         if( required[j] > 0 )
+            items.push_back(required[j]);
+      }
+      for( int i = 0; i < n; ++i )
+      {
+         if( !packed[i] && !removed[i] && weight[i] > 0 )
+            items.push_back(weight[i]);
+      }
+      sort(items.begin(), items.end(), greater<long long>());
+      bound = LowerBound::boundL2(items, capacity);
+   }
+   else
+      bound = capacity > 0 ? (long long) ceil(total / capacity - 1e-9) : 0;
+
+   if( bound > available )
+      *cutoff = TRUE;
+   else if( bound > SCIPgetLocalLowerbound(scip) + 0.5 )
+      SCIP_CALL(SCIPupdateLocalLowerbound(scip, (double) bound));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief transform the constraint and store the transformed variables of the model
+ *
+ * @note The variables are transformed before the constraints. They must not be multi-aggregated by the presolving, as
+ * the propagation reads and fixes their local bounds.
+ */
+SCIP_DECL_CONSTRANS(ConsBinPacking::scip_trans)
+{
+   _trans_X.resize(_var_X.size());
+   for( size_t k = 0; k < _var_X.size(); ++k )
+   {
+      SCIP_CALL(SCIPgetTransformedVar(scip, _var_X[k], &_trans_X[k]));
+      SCIP_CALL(SCIPmarkDoNotMultaggrVar(scip, _trans_X[k]));
+   }
+
+   _trans_Y.resize(_var_Y.size());
+   for( size_t j = 0; j < _var_Y.size(); ++j )
+   {
+      SCIP_CALL(SCIPgetTransformedVar(scip, _var_Y[j], &_trans_Y[j]));
+      SCIP_CALL(SCIPmarkDoNotMultaggrVar(scip, _trans_Y[j]));
+   }
+
+   SCIP_CALL(SCIPcreateCons(scip,
+                            targetcons,
+                            SCIPconsGetName(sourcecons),
+                            conshdlr,
+                            NULL,
+                            SCIPconsIsInitial(sourcecons),
+                            SCIPconsIsSeparated(sourcecons),
+                            SCIPconsIsEnforced(sourcecons),
+                            SCIPconsIsChecked(sourcecons),
+                            SCIPconsIsPropagated(sourcecons),
+                            SCIPconsIsLocal(sourcecons),
+                            SCIPconsIsModifiable(sourcecons),
+                            SCIPconsIsDynamic(sourcecons),
+                            SCIPconsIsRemovable(sourcecons),
+                            SCIPconsIsStickingAtNode(sourcecons)));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief domain propagation of the global bin-packing constraint
+ */
+SCIP_DECL_CONSPROP(ConsBinPacking::scip_prop)
+{
+   *result = SCIP_DIDNOTFIND;
+
+   if( _trans_Y.empty() )
+      return SCIP_OKAY;
+
+   SCIP_Bool cutoff     = FALSE;
+   int       nfixedvars = 0;
+
+   if( _ins->_integral )
+      SCIP_CALL(propagate(scip, _ins->int_w, _ins->int_b, &nfixedvars, &cutoff));
+   else
+      SCIP_CALL(propagate(scip, _ins->par_w, _ins->par_b, &nfixedvars, &cutoff));
+
+   _nbFixings += nfixedvars;
+
+   if( cutoff )
+   {
+      ++_nbCutoffs;
+      *result = SCIP_CUTOFF;
+   }
+   else if( nfixedvars > 0 )
+      *result = SCIP_REDUCEDDOM;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief LP enforcement: nothing to do, the linear constraints of the model enforce the packing
+ */
+SCIP_DECL_CONSENFOLP(ConsBinPacking::scip_enfolp)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief pseudo solution enforcement: nothing to do, the linear constraints of the model enforce the packing
+ */
+SCIP_DECL_CONSENFOPS(ConsBinPacking::scip_enfops)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief feasibility check: nothing to do, the linear constraints of the model check the packing
+ */
+SCIP_DECL_CONSCHECK(ConsBinPacking::scip_check)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief variable locks: the constraint is not checked, so it does not lock any variable
+ */
+SCIP_DECL_CONSLOCK(ConsBinPacking::scip_lock) { return SCIP_OKAY; }
+
+/**
+ * @brief print the constraint in a human readable form
+ */
+SCIP_DECL_CONSPRINT(ConsBinPacking::scip_print)
+{
+   SCIPinfoMessage(scip, file, "binpacking(%d items, %d bins)", _ins->_nbItems, (int) _var_Y.size());
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,83 @@
+// ConsBinPacking.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief constraint handler for a global bin-packing constraint over the variables X_ij and Y_j of the compact model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _var_X, _var_X_begin, _var_Y (original) variables of the compact model, see CompactModel
+ *
+ * @param _trans_X, _trans_Y transformed variables, set when the constraint is transformed
+ *
+ * @note The linear capacity constraints only see a single bin each. The global constraint propagates all bins together
+ * (Shaw, "A constraint for bin packing", 2004). The load of bin j lies between
+ * - minLoad_j = max(required_j, total weight - sum of maxLoad_k over all other bins k) and
+ * - maxLoad_j = min(b, possible_j), 0 if Y_j = 0,
+ * where required_j is the weight of the items fixed to bin j and possible_j additionally contains the items, which may
+ * still be packed into bin j. For integral weights, knapsack reasoning tightens both values to the nearest load, which
+ * the candidates of the bin can reach (subset-sum bitset, up to a capacity of _maxDPCapacity). The propagation fixes
+ * - Y_j = 1, if minLoad_j > 0,
+ * - X_ij = 0, if item i does not fit into maxLoad_j on top of required_j,
+ * - X_ij = 1, if bin j can not reach minLoad_j without item i,
+ * and cuts off the node, if minLoad_j > maxLoad_j or no load in [minLoad_j, maxLoad_j] can be reached. The rules are
+ * repeated up to _maxRounds times, as long as they fix variables. Finally, the bins with fixed items are merged into
+ * single items of their required load, and L2 of Martello and Toth of these items and the unpacked items (L1 for
+ * fractional weights) is a lower bound on the number of bins of every packing in the subtree: the node is cut off, if
+ * it exceeds the number of bins, which may still be used, otherwise it is passed to SCIP as local lower bound. The
+ * constraint is only propagated, the linear constraints still check and enforce the packing.
+ */
+class ConsBinPacking : public ObjConshdlr
+{
+public:
+   // constructor
+   ConsBinPacking(SCIP*                     scip,
+                  Instance*                 ins,
+                  const vector<SCIP_VAR*>&  var_X,
+                  const vector<int>&        var_X_begin,
+                  const vector<SCIP_VAR*>&  var_Y);
+
+   // destructor
+   virtual ~ConsBinPacking() {}
+
+   virtual SCIP_DECL_CONSTRANS(scip_trans);
+   virtual SCIP_DECL_CONSPROP(scip_prop);
+   virtual SCIP_DECL_CONSENFOLP(scip_enfolp);
+   virtual SCIP_DECL_CONSENFOPS(scip_enfops);
+   virtual SCIP_DECL_CONSCHECK(scip_check);
+   virtual SCIP_DECL_CONSLOCK(scip_lock);
+   virtual SCIP_DECL_CONSPRINT(scip_print);
+
+   long long _nbFixings; // number of variables fixed by the propagation
+   long long _nbCutoffs; // number of nodes cut off by the propagation
+
+private:
+   // propagate the constraint with weights of type W (double or long long)
+   template <typename W>
+   SCIP_RETCODE propagate(SCIP* scip, const vector<W>& weight, W capacity, int* nfixedvars, SCIP_Bool* cutoff);
+
+   // fix a binary variable, count the fixing and detect infeasibility
+   SCIP_RETCODE fix(SCIP* scip, SCIP_VAR* var, double value, int* nfixedvars, SCIP_Bool* cutoff);
+
+   Instance* _ins; // pointer to the instance
+
+   const vector<SCIP_VAR*>& _var_X;       // X_ij of the compact model, X_ij at position _var_X_begin[i] + j
+   const vector<int>&       _var_X_begin; // first position of the variables of item i in _var_X
+   const vector<SCIP_VAR*>& _var_Y;       // Y_j of the compact model
+
+   vector<SCIP_VAR*> _trans_X; // transformed X_ij, same positions as _var_X
+   vector<SCIP_VAR*> _trans_Y; // transformed Y_j
+
+   int       _maxRounds;     // maximal number of rounds of the propagation rules per call
+   long long _maxDPCapacity; // maximal capacity, up to which the knapsack reasoning is used
+};
+
+// create the global bin-packing constraint, the constraint handler has to be included
+SCIP_RETCODE createConsBinPacking(SCIP* scip, SCIP_CONS** cons, const char* name);
@@ -0,0 +1,278 @@
+// ConsSameDiff.cpp
+#include "ConsSameDiff.h"
+#include "PatternVardata.h"
+
+/**
+ * @brief Construct a new ConsSameDiff:: ConsSameDiff object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @note The constraint handler only propagates, it never separates, enforces or checks. The check priority is very
+ * high, so that the handler is asked first, which is cheap as it always returns feasible.
+ */
+ConsSameDiff::ConsSameDiff(SCIP* scip)
+    : ObjConshdlr(scip,
+                  "samediff",                                 // name
+                  "stores the local branching decisions",     // description
+                  0,                                          // priority for separation
+                  0,                                          // priority for constraint enforcing
+                  9999999,                                    // priority for checking feasibility
+                  -1,                                         // frequency for separating cuts
+                  1,                                          // frequency for propagating domains
+                  1,                                          // frequency for using all instead of only useful conss
+                  0,                                          // maximal number of presolving rounds
+                  FALSE,                                      // delay separation
+                  FALSE,                                      // delay propagation
+                  TRUE,                                       // only call the handler if constraints are present
+                  SCIP_PROPTIMING_BEFORELP,                   // propagation timing
+                  SCIP_PRESOLTIMING_FAST)                     // presolving timing
+{
+}
+
+/**
+ * @brief create a same/differ constraint
+ *
+ * @note The constraint is only propagated. It is created as a local constraint, which sticks at the given node, so
+ * SCIP activates it whenever this node or one of its children is focused.
+ */
+SCIP_RETCODE createConsSameDiff(SCIP*       scip,
+                                SCIP_CONS** cons,
+                                const char* name,
+                                int         item1,
+                                int         item2,
+                                ConsType    type,
+                                SCIP_NODE*  node,
+                                SCIP_Bool   local)
+{
+   SCIP_CONSHDLR* conshdlr = SCIPfindConshdlr(scip, "samediff");
+   if( conshdlr == NULL )
+   {
+      SCIPerrorMessage("samediff constraint handler not found\n");
+      return SCIP_PLUGINNOTFOUND;
+   }
+
+   SCIP_CONSDATA* consdata   = new SCIP_CONSDATA;
+   consdata->item1           = item1;
+   consdata->item2           = item2;
+   consdata->type            = type;
+   consdata->npropagatedvars = 0;
+   consdata->npropagations   = 0;
+   consdata->propagated      = FALSE;
+   consdata->node            = node;
+
+   SCIP_CALL(SCIPcreateCons(scip,
+                            cons,
+                            name,
+                            conshdlr,
+                            consdata,
+                            FALSE,  // initial
+                            FALSE,  // separate
+                            FALSE,  // enforce
+                            FALSE,  // check
+                            TRUE,   // propagate
+                            local,  // local
+                            FALSE,  // modifiable
+                            FALSE,  // dynamic
+                            FALSE,  // removable
+                            TRUE)); // stickingatnode
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief fix all pattern variables to zero, which violate the branching decision
+ *
+ * @note Only the variables with index consdata->npropagatedvars, ..., nvars - 1 are checked. A SAME-constraint forbids
+ * every pattern, which contains exactly one of the two items, a DIFFER-constraint forbids every pattern, which contains
+ * both items.
+ */
+SCIP_RETCODE ConsSameDiff::checkVariables(SCIP*          scip,
+                                          SCIP_CONSDATA* consdata,
+                                          int            nvars,
+                                          SCIP_VAR**     vars,
+                                          int*           nfixedvars,
+                                          SCIP_Bool*     cutoff)
+{
+   for( int v = consdata->npropagatedvars; v < nvars && !(*cutoff); ++v )
+   {
+      SCIP_VAR* var = vars[v];
+
+      // variables that are already fixed to zero can be skipped
+      if( SCIPvarGetUbLocal(var) < 0.5 )
+         continue;
+
+      PatternVardata* vardata = dynamic_cast<PatternVardata*>(SCIPgetObjVardata(scip, var));
+      if( vardata == NULL )
+         continue;
+
+      bool existitem1 = vardata->contains(consdata->item1);
+      bool existitem2 = vardata->contains(consdata->item2);
+
+      if( (consdata->type == SAME && existitem1 != existitem2) ||
+          (consdata->type == DIFFER && existitem1 && existitem2) )
+      {
+         SCIP_Bool infeasible;
+         SCIP_Bool fixed;
+
+         SCIP_CALL(SCIPfixVar(scip, var, 0.0, &infeasible, &fixed));
+
+         if( infeasible )
+            *cutoff = TRUE;
+         else if( fixed )
+            ++(*nfixedvars);
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief free the constraint data
+ */
+SCIP_DECL_CONSDELETE(ConsSameDiff::scip_delete)
+{
+   delete *consdata;
+   *consdata = NULL;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief transform an original constraint into a transformed one by copying its data
+ */
+SCIP_DECL_CONSTRANS(ConsSameDiff::scip_trans)
+{
+   SCIP_CONSDATA* sourcedata = SCIPconsGetData(sourcecons);
+   SCIP_CONSDATA* targetdata = new SCIP_CONSDATA(*sourcedata);
+
+   SCIP_CALL(SCIPcreateCons(scip,
+                            targetcons,
+                            SCIPconsGetName(sourcecons),
+                            conshdlr,
+                            targetdata,
+                            SCIPconsIsInitial(sourcecons),
+                            SCIPconsIsSeparated(sourcecons),
+                            SCIPconsIsEnforced(sourcecons),
+                            SCIPconsIsChecked(sourcecons),
+                            SCIPconsIsPropagated(sourcecons),
+                            SCIPconsIsLocal(sourcecons),
+                            SCIPconsIsModifiable(sourcecons),
+                            SCIPconsIsDynamic(sourcecons),
+                            SCIPconsIsRemovable(sourcecons),
+                            SCIPconsIsStickingAtNode(sourcecons)));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief domain propagation: fix all pattern variables, which violate an active branching decision
+ */
+SCIP_DECL_CONSPROP(ConsSameDiff::scip_prop)
+{
+   *result = SCIP_DIDNOTFIND;
+
+   SCIP_VAR** vars  = SCIPgetVars(scip);
+   int        nvars = SCIPgetNVars(scip);
+
+   SCIP_Bool cutoff     = FALSE;
+   int       nfixedvars = 0;
+
+   for( int c = 0; c < nconss && !cutoff; ++c )
+   {
+      SCIP_CONSDATA* consdata = SCIPconsGetData(conss[c]);
+
+      if( !consdata->propagated )
+      {
+         SCIP_CALL(checkVariables(scip, consdata, nvars, vars, &nfixedvars, &cutoff));
+
+         consdata->npropagatedvars = nvars;
+         consdata->propagated      = TRUE;
+         ++consdata->npropagations;
+      }
+   }
+
+   if( cutoff )
+      *result = SCIP_CUTOFF;
+   else if( nfixedvars > 0 )
+      *result = SCIP_REDUCEDDOM;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief constraint activation: repropagate the node, if new variables have been priced in since the last propagation
+ */
+SCIP_DECL_CONSACTIVE(ConsSameDiff::scip_active)
+{
+   SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+
+   if( consdata->npropagatedvars != SCIPgetNTotalVars(scip) )
+   {
+      consdata->propagated = FALSE;
+      SCIP_CALL(SCIPrepropagateNode(scip, consdata->node));
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief constraint deactivation: all variables priced in below the node respect the constraint
+ */
+SCIP_DECL_CONSDEACTIVE(ConsSameDiff::scip_deactive)
+{
+   SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+
+   consdata->npropagatedvars = SCIPgetNTotalVars(scip);
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief LP enforcement: nothing to do, the constraint is respected by the propagation and the pricer
+ */
+SCIP_DECL_CONSENFOLP(ConsSameDiff::scip_enfolp)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief pseudo solution enforcement: nothing to do, the constraint is respected by the propagation and the pricer
+ */
+SCIP_DECL_CONSENFOPS(ConsSameDiff::scip_enfops)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief feasibility check: branching decisions never cut off a feasible packing
+ */
+SCIP_DECL_CONSCHECK(ConsSameDiff::scip_check)
+{
+   *result = SCIP_FEASIBLE;
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief variable locks: the constraint does not lock any variable
+ */
+SCIP_DECL_CONSLOCK(ConsSameDiff::scip_lock) { return SCIP_OKAY; }
+
+/**
+ * @brief print the constraint in a human readable form
+ */
+SCIP_DECL_CONSPRINT(ConsSameDiff::scip_print)
+{
+   SCIP_CONSDATA* consdata = SCIPconsGetData(cons);
+
+   SCIPinfoMessage(scip,
+                   file,
+                   "%s(%d,%d) at node %lld",
+                   consdata->type == SAME ? "same" : "diff",
+                   consdata->item1,
+                   consdata->item2,
+                   SCIPnodeGetNumber(consdata->node));
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,82 @@
+// ConsSameDiff.h
+#pragma once
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief type of a Ryan-Foster branching decision
+ */
+enum ConsType
+{
+   DIFFER = 0, // the two items must be packed into different bins
+   SAME   = 1  // the two items must be packed into the same bin
+};
+
+/**
+ * @brief constraint data of a same/differ constraint
+ *
+ * @note Every branching decision of the Ryan-Foster branching rule is stored as a local constraint, which sticks at the
+ * node it was created for. The constraint knows the number of variables that were already checked, so that the
+ * propagation only looks at the pattern variables that have been priced in since the last call.
+ */
+struct SCIP_ConsData
+{
+   int        item1;           // first item of the pair
+   int        item2;           // second item of the pair
+   ConsType   type;            // SAME or DIFFER
+   int        npropagatedvars; // number of variables that already have been propagated
+   int        npropagations;   // number of times this constraint has been propagated
+   SCIP_Bool  propagated;      // is the constraint already propagated?
+   SCIP_NODE* node;            // the node in the B&B-tree at which the constraint is sticking
+};
+
+/**
+ * @brief constraint handler for the same/differ constraints of the Ryan-Foster branching
+ *
+ * @note The constraint handler fixes all pattern variables to zero, which violate an active branching decision: for a
+ * SAME-constraint every pattern containing exactly one of the two items, for a DIFFER-constraint every pattern
+ * containing both items. The constraints are never checked or enforced, because the pricer only generates patterns,
+ * which respect all active branching decisions.
+ */
+class ConsSameDiff : public ObjConshdlr
+{
+public:
+   // constructor
+   ConsSameDiff(SCIP* scip);
+
+   // destructor
+   virtual ~ConsSameDiff() {}
+
+   virtual SCIP_DECL_CONSDELETE(scip_delete);
+   virtual SCIP_DECL_CONSTRANS(scip_trans);
+   virtual SCIP_DECL_CONSPROP(scip_prop);
+   virtual SCIP_DECL_CONSACTIVE(scip_active);
+   virtual SCIP_DECL_CONSDEACTIVE(scip_deactive);
+   virtual SCIP_DECL_CONSENFOLP(scip_enfolp);
+   virtual SCIP_DECL_CONSENFOPS(scip_enfops);
+   virtual SCIP_DECL_CONSCHECK(scip_check);
+   virtual SCIP_DECL_CONSLOCK(scip_lock);
+   virtual SCIP_DECL_CONSPRINT(scip_print);
+
+private:
+   // fix all pattern variables from consdata->npropagatedvars on, which violate the constraint
+   SCIP_RETCODE checkVariables(SCIP*          scip,
+                               SCIP_CONSDATA* consdata,
+                               int            nvars,
+                               SCIP_VAR**     vars,
+                               int*           nfixedvars,
+                               SCIP_Bool*     cutoff);
+};
+
+// create a same/differ constraint for the items item1 and item2, which sticks at the given node
+SCIP_RETCODE createConsSameDiff(SCIP*       scip,
+                                SCIP_CONS** cons,
+                                const char* name,
+                                int         item1,
+                                int         item2,
+                                ConsType    type,
+                                SCIP_NODE*  node,
+                                SCIP_Bool   local);
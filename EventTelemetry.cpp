@@ -0,0 +1,182 @@
+// EventTelemetry.cpp
+#include "EventTelemetry.h"
+
+// events of the trajectory
+#define TELEMETRY_EVENTS (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED)
+
+/**
+ * @brief Construct a new EventTelemetry:: EventTelemetry object
+ *
+ * @param scip pointer to the scip environment
+ */
+EventTelemetry::EventTelemetry(SCIP* scip)
+    : ObjEventhdlr(scip,
+                   "telemetry",                                      // name
+                   "records the trajectory of primal and dual bound") // description
+{
+}
+
+/**
+ * @brief catch the events at the beginning of the solve
+ */
+SCIP_DECL_EVENTINITSOL(EventTelemetry::scip_initsol)
+{
+   _trajectory.clear();
+   SCIP_CALL(SCIPcatchEvent(scip, TELEMETRY_EVENTS, eventhdlr, NULL, NULL));
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief drop the events at the end of the solve
+ *
+ * @note The bounds can not be read any more in this stage, so the last point is recorded by finish().
+ */
+SCIP_DECL_EVENTEXITSOL(EventTelemetry::scip_exitsol)
+{
+   SCIP_CALL(SCIPdropEvent(scip, TELEMETRY_EVENTS, eventhdlr, NULL, -1));
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief record a point for a new incumbent or a solved node
+ */
+SCIP_DECL_EVENTEXEC(EventTelemetry::scip_exec)
+{
+   if( SCIPeventGetType(event) & SCIP_EVENTTYPE_BESTSOLFOUND )
+      record(scip, "solution", true);
+   else
+      record(scip, "node", false);
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief record the last point, after SCIPsolve has returned
+ */
+void EventTelemetry::finish(SCIP* scip) { record(scip, "end", true); }
+
+/**
+ * @brief record a point
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param event name of the event
+ *
+ * @param force true: record the point, even if the bounds have not changed
+ */
+void EventTelemetry::record(SCIP* scip, const char* event, bool force)
+{
+   TelemetryPoint point;
+   point._time         = SCIPgetSolvingTime(scip);
+   point._primal       = SCIPgetPrimalbound(scip);
+   point._dual         = SCIPgetDualbound(scip);
+   point._nodes        = SCIPgetNNodes(scip);
+   point._lpIterations = SCIPgetNLPIterations(scip);
+   point._event        = event;
+
+   if( !force && !_trajectory.empty() && _trajectory.back()._primal == point._primal
+       && _trajectory.back()._dual == point._dual )
+      return;
+
+   _trajectory.push_back(point);
+}
+
+/**
+ * @brief the trajectory as a JSON array
+ */
+string EventTelemetry::toJSON() const
+{
+   ostringstream json;
+   json << "[";
+   for( size_t p = 0; p < _trajectory.size(); ++p )
+   {
+      const TelemetryPoint& point = _trajectory[p];
+      json << (p > 0 ? "," : "") << "{\"time\":" << point._time << ",\"primal\":" << point._primal
+           << ",\"dual\":" << point._dual << ",\"nodes\":" << point._nodes
+           << ",\"lp_iterations\":" << point._lpIterations << ",\"event\":\"" << point._event << "\"}";
+   }
+   json << "]";
+   return json.str();
+}
+
+/**
+ * @brief the time and the number of calls of every plugin of a kind as a JSON object
+ *
+ * @param plugins array of the plugins
+ *
+ * @param nplugins number of plugins
+ *
+ * @param getName, getTime, getNCalls getters of the plugin kind
+ *
+ * @note Plugins, which were never called, are left out.
+ */
+template <typename PLUGIN, typename NCALLS>
+static string pluginsJSON(PLUGIN** plugins, int nplugins, const char* (*getName)(PLUGIN*),
+                          SCIP_Real (*getTime)(PLUGIN*), NCALLS (*getNCalls)(PLUGIN*))
+{
+   ostringstream json;
+   bool          first = true;
+
+   json << "{";
+   for( int p = 0; p < nplugins; ++p )
+   {
+      if( getNCalls(plugins[p]) == 0 )
+         continue;
+
+      json << (first ? "" : ",") << "\"" << getName(plugins[p]) << "\":{\"time\":" << getTime(plugins[p])
+           << ",\"calls\":" << getNCalls(plugins[p]) << "}";
+      first = false;
+   }
+   json << "}";
+   return json.str();
+}
+
+/**
+ * @brief the statistics of a solved SCIP environment as a single JSON object
+ *
+ * @param scip pointer to the scip environment after SCIPsolve
+ *
+ * @param telemetry event handler, whose trajectory is added, or NULL
+ *
+ * @note The object contains the global counters (times, nodes, LP iterations, solutions) and the time and the number
+ * of calls of every presolver, propagator, separator, heuristic, branching rule and pricer, which was called, and of the
+ * propagation of every constraint handler. The values are read by the public getters of SCIP, so they are the same as
+ * in the output of SCIPprintStatistics().
+ */
+string statisticsJSON(SCIP* scip, const EventTelemetry* telemetry)
+{
+   ostringstream json;
+
+   json << "{\"solving_time\":" << SCIPgetSolvingTime(scip) << ",\"presolving_time\":" << SCIPgetPresolvingTime(scip)
+        << ",\"first_lp_time\":" << SCIPgetFirstLPTime(scip) << ",\"nodes\":" << SCIPgetNTotalNodes(scip)
+        << ",\"max_depth\":" << SCIPgetMaxDepth(scip) << ",\"runs\":" << SCIPgetNRuns(scip)
+        << ",\"lps\":" << SCIPgetNLPs(scip) << ",\"lp_iterations\":" << SCIPgetNLPIterations(scip)
+        << ",\"root_lp_iterations\":" << SCIPgetNRootLPIterations(scip)
+        << ",\"solutions_found\":" << SCIPgetNSolsFound(scip) << ",\"primal_bound\":" << SCIPgetPrimalbound(scip)
+        << ",\"dual_bound\":" << SCIPgetDualbound(scip) << ",\"gap\":" << SCIPgetGap(scip);
+
+   json << ",\"presolvers\":"
+        << pluginsJSON(SCIPgetPresols(scip), SCIPgetNPresols(scip), SCIPpresolGetName, SCIPpresolGetTime,
+                       SCIPpresolGetNCalls);
+   json << ",\"propagators\":"
+        << pluginsJSON(SCIPgetProps(scip), SCIPgetNProps(scip), SCIPpropGetName, SCIPpropGetTime, SCIPpropGetNCalls);
+   json << ",\"constraint_handlers\":"
+        << pluginsJSON(SCIPgetConshdlrs(scip), SCIPgetNConshdlrs(scip), SCIPconshdlrGetName, SCIPconshdlrGetPropTime,
+                       SCIPconshdlrGetNPropCalls);
+   json << ",\"separators\":"
+        << pluginsJSON(SCIPgetSepas(scip), SCIPgetNSepas(scip), SCIPsepaGetName, SCIPsepaGetTime, SCIPsepaGetNCalls);
+   json << ",\"heuristics\":"
+        << pluginsJSON(SCIPgetHeurs(scip), SCIPgetNHeurs(scip), SCIPheurGetName, SCIPheurGetTime, SCIPheurGetNCalls);
+   json << ",\"branchrules\":"
+        << pluginsJSON(SCIPgetBranchrules(scip), SCIPgetNBranchrules(scip), SCIPbranchruleGetName,
+                       SCIPbranchruleGetTime, SCIPbranchruleGetNLPCalls);
+   json << ",\"pricers\":"
+        << pluginsJSON(SCIPgetPricers(scip), SCIPgetNPricers(scip), SCIPpricerGetName, SCIPpricerGetTime,
+                       SCIPpricerGetNCalls);
+
+   if( telemetry != NULL )
+      json << ",\"trajectory\":" << telemetry->toJSON();
+
+   json << "}";
+   return json.str();
+}
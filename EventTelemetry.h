@@ -0,0 +1,66 @@
+// EventTelemetry.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief a single point of the bound trajectory
+ */
+struct TelemetryPoint
+{
+   double      _time;         // solving time in seconds
+   double      _primal;       // primal bound (number of bins of the incumbent)
+   double      _dual;         // dual bound
+   long long   _nodes;        // number of processed nodes
+   long long   _lpIterations; // number of LP iterations
+   const char* _event;        // "solution" for a new incumbent, "node" for a solved node, "end" for the last point
+};
+
+/**
+ * @brief event handler, which records the trajectory of the primal and the dual bound
+ *
+ * @param _trajectory recorded points, in the order of the solving time
+ *
+ * @note The handler catches every new incumbent and every solved node. A point is only recorded, if the primal or the
+ * dual bound has changed since the last point, so the trajectory stays short, even if millions of nodes are solved.
+ * The last point is recorded by finish() after SCIPsolve. The handler is owned by SCIP; the trajectory has to be
+ * read (see statisticsJSON()) before the SCIP environment is freed.
+ */
+class EventTelemetry : public ObjEventhdlr
+{
+public:
+   // constructor
+   EventTelemetry(SCIP* scip);
+
+   // destructor
+   virtual ~EventTelemetry() {}
+
+   // catch the events at the beginning of the solve
+   virtual SCIP_DECL_EVENTINITSOL(scip_initsol);
+
+   // drop the events at the end of the solve
+   virtual SCIP_DECL_EVENTEXITSOL(scip_exitsol);
+
+   // record a point for a new incumbent or a solved node
+   virtual SCIP_DECL_EVENTEXEC(scip_exec);
+
+   // record the last point, after SCIPsolve has returned
+   void finish(SCIP* scip);
+
+   // the trajectory as a JSON array
+   string toJSON() const;
+
+   vector<TelemetryPoint> _trajectory; // recorded points
+
+private:
+   // record a point, if the bounds have changed (or always, if force is true)
+   void record(SCIP* scip, const char* event, bool force);
+};
+
+// the statistics of a solved SCIP environment as a single JSON object, with the trajectory of telemetry, if not NULL
+string statisticsJSON(SCIP* scip, const EventTelemetry* telemetry);
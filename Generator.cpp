@@ -0,0 +1,116 @@
+// Generator.cpp
+#include "Generator.h"
+
+#include <random>
+
+/**
+ * @brief uniform random integer in [low, high], reproducible on every platform
+ */
+static long long uniform(mt19937_64& rng, long long low, long long high)
+{
+   return low + (long long) (rng() % (uint64_t) (high - low + 1));
+}
+
+/**
+ * @brief generate a random instance of one of the standard benchmark families
+ *
+ * @note For the triplets, the first item of every triplet is drawn from [380, 490], the second from [250, b - 250 -
+ * first] and the third fills the bin. The items are shuffled afterwards, so the triplets can not be read from the
+ * order of the items. A number of items, which is no multiple of 3, is rejected, as it can not form triplets.
+ */
+bool generateInstance(const string& family, int nbItems, uint64_t seed, Instance& ins)
+{
+   mt19937_64 rng(seed);
+
+   ins.par_w.clear();
+
+   if( family == "uniform" )
+   {
+      ins.par_b = 150;
+      for( int i = 0; i < nbItems; ++i )
+      {
+         ins.par_w.push_back((double) uniform(rng, 20, 100));
+      }
+   }
+   else if( family == "triplets" )
+   {
+      if( nbItems % 3 != 0 )
+         return false;
+
+      ins.par_b = 1000;
+      for( int i = 0; i < nbItems; i += 3 )
+      {
+         long long first  = uniform(rng, 380, 490);
+         long long second = uniform(rng, 250, 1000 - 250 - first);
+         ins.par_w.push_back((double) first);
+         ins.par_w.push_back((double) second);
+         ins.par_w.push_back((double) (1000 - first - second));
+      }
+      for( size_t i = ins.par_w.size(); i > 1; --i )
+      {
+         swap(ins.par_w[i - 1], ins.par_w[(size_t) uniform(rng, 0, (long long) i - 1)]);
+      }
+   }
+   else if( family == "scholl" )
+   {
+      const long long capacity[3] = {100, 120, 150};
+      const long long low[3]      = {1, 20, 30};
+
+      ins.par_b = (double) capacity[seed % 3];
+      for( int i = 0; i < nbItems; ++i )
+      {
+         ins.par_w.push_back((double) uniform(rng, low[(seed / 3) % 3], 100));
+      }
+   }
+   else if( family == "hard28" )
+   {
+      ins.par_b = 1000;
+      for( int i = 0; i < nbItems; ++i )
+      {
+         ins.par_w.push_back((double) uniform(rng, 200, 800));
+      }
+   }
+   else
+   {
+      return false;
+   }
+
+   ins._nbItems = (int) ins.par_w.size();
+   ins._nbBins  = ins._nbItems;
+   ins.setIntegral();
+
+   return true;
+}
+
+/**
+ * @brief optimal number of bins of a generated instance, if it is known by construction
+ *
+ * @note Only the triplets have a known optimum: every bin of an optimal packing is filled exactly.
+ */
+int knownOptimum(const string& family, int nbItems)
+{
+   if( family == "triplets" )
+      return nbItems % 3 == 0 ? nbItems / 3 : -1;
+
+   return -1;
+}
+
+/**
+ * @brief write an instance in the BPPLIB format
+ *
+ * @note The format is read by Instance::read(), so a generated instance can be solved like every other instance file.
+ */
+bool writeInstance(const Instance& ins, const string& fileName)
+{
+   ofstream file(fileName);
+   if( !file )
+      return false;
+
+   file << ins._nbItems << "\n" << ins.par_b << "\n";
+   for( int i = 0; i < ins._nbItems; ++i )
+   {
+      file << ins.par_w[i] << "\n";
+   }
+
+   return (bool) file;
+}
@@ -0,0 +1,37 @@
+// Generator.h
+#pragma once
+
+#include "Instance.h"
+
+#include <cstdint>
+
+/**
+ * @brief generate a random instance of one of the standard benchmark families
+ *
+ * @param family "uniform", "triplets", "scholl" or "hard28"
+ *
+ * @param nbItems number of items, a multiple of 3 for "triplets"
+ *
+ * @param seed seed of the random number generator
+ *
+ * @param ins returns the instance, _nbBins is set to _nbItems
+ *
+ * @return false, if the family is unknown or the number of triplet items is no multiple of 3
+ *
+ * @note The families follow the classical benchmark sets:
+ * - uniform: Falkenauer U, b = 150, weights uniform in [20, 100],
+ * - triplets: Falkenauer T, b = 1000, weights in [250, 500], the items form triplets, which fill a bin exactly, so
+ *   nbItems / 3 bins are optimal,
+ * - scholl: Scholl set 1, b in {100, 120, 150} and weights uniform in [1, 100], [20, 100] or [30, 100], both chosen
+ *   by the seed,
+ * - hard28: instances in the style of the hard28 set, b = 1000, weights uniform in [200, 800].
+ * The random numbers are drawn from std::mt19937_64, whose output is fixed by the standard, and mapped to a range by
+ * the modulo operator, so an instance is reproducible from family, number of items and seed on every platform.
+ */
+bool generateInstance(const string& family, int nbItems, uint64_t seed, Instance& ins);
+
+// optimal number of bins of a generated instance, if it is known by construction, -1 otherwise
+int knownOptimum(const string& family, int nbItems);
+
+// write an instance in the BPPLIB format (number of items, capacity, one weight per line), false on failure
+bool writeInstance(const Instance& ins, const string& fileName);
@@ -0,0 +1,274 @@
+// HeurRounding.cpp
+#include "HeurRounding.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Construct a new HeurRounding:: HeurRounding object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param ins pointer to the instance
+ *
+ * @param var_X, var_X_begin, var_Y variables of the compact model, the vectors are owned by the model
+ *
+ * @param freq frequency of the calls (depth in the tree), 0: only at the root node, -1: never
+ */
+HeurRounding::HeurRounding(SCIP*                    scip,
+                           Instance*                ins,
+                           const vector<SCIP_VAR*>& var_X,
+                           const vector<int>&       var_X_begin,
+                           const vector<SCIP_VAR*>& var_Y,
+                           int                      freq)
+    : ObjHeur(scip,
+              "bprounding",                                  // name
+              "LP-guided Best-Fit with bin elimination",     // description
+              'b',                                           // display character
+              -1000,                                         // priority
+              freq,                                          // frequency
+              0,                                             // frequency offset
+              -1,                                            // maximal depth
+              SCIP_HEURTIMING_AFTERLPNODE,                   // timing
+              FALSE),                                        // uses a sub-SCIP
+      _var_X(var_X),
+      _var_X_begin(var_X_begin),
+      _var_Y(var_Y)
+{
+   _ins         = ins;
+   _nbSolutions = 0;
+}
+
+/**
+ * @brief LP-guided Best-Fit and bin elimination
+ *
+ * @param weight weight of every item, the integral weights of the instance or the doubles
+ *
+ * @param capacity capacity of a bin
+ *
+ * @param lpValue LP value of every X_ij, same positions as _var_X
+ *
+ * @param bin_of_item returns the bin of every item, -1 for removed items
+ *
+ * @return the number of used bins, -1 if the model has not enough bins for the packing
+ */
+template <typename W>
+int HeurRounding::round(const vector<W>& weight, W capacity, const vector<double>& lpValue, vector<int>& bin_of_item)
+{
+   int n = _ins->_nbItems;
+   int m = (int) _var_Y.size();
+
+   vector<int> order;
+   for( int i = 0; i < n; ++i )
+   {
+      // removed items have all their variables fixed to 0
+      for( int k = _var_X_begin[i]; k < _var_X_begin[i + 1]; ++k )
+      {
+         if( SCIPvarGetUbGlobal(_var_X[k]) > 0.5 )
+         {
+            order.push_back(i);
+            break;
+         }
+      }
+   }
+   stable_sort(order.begin(), order.end(), [&weight](int a, int b) { return weight[a] > weight[b]; });
+
+   bin_of_item.assign(n, -1);
+   vector<W> load(m, 0);
+   vector<int> size(m, 0); // number of items in every bin
+
+   // Best-Fit into a used bin other than the given one, -1 if no used bin fits
+   auto bestFit = [&](W w, int except)
+   {
+      int chosen = -1;
+      for( int j = 0; j < m; ++j )
+      {
+         if( j != except && size[j] > 0 && fits(load[j], w, capacity) && (chosen == -1 || load[j] > load[chosen]) )
+            chosen = j;
+      }
+      return chosen;
+   };
+
+   // ###################################################################################################################
+   //  LP-guided Best-Fit
+   // ###################################################################################################################
+
+   for( int i : order )
+   {
+      // bins of the LP support by decreasing LP value
+      vector<int> support;
+      for( int j = 0; j < _var_X_begin[i + 1] - _var_X_begin[i]; ++j )
+      {
+         if( lpValue[_var_X_begin[i] + j] > 1e-6 )
+            support.push_back(j);
+      }
+      stable_sort(support.begin(),
+                  support.end(),
+                  [&](int a, int b) { return lpValue[_var_X_begin[i] + a] > lpValue[_var_X_begin[i] + b]; });
+
+      int chosen = -1;
+      for( int j : support )
+      {
+         if( fits(load[j], weight[i], capacity) )
+         {
+            chosen = j;
+            break;
+         }
+      }
+
+      if( chosen == -1 )
+         chosen = bestFit(weight[i], -1);
+
+      // open the first empty bin
+      for( int j = 0; j < m && chosen == -1; ++j )
+      {
+         if( size[j] == 0 )
+            chosen = j;
+      }
+
+      if( chosen == -1 )
+         return -1;
+
+      bin_of_item[i] = chosen;
+      load[chosen] += weight[i];
+      ++size[chosen];
+   }
+
+   // ###################################################################################################################
+   //  bin elimination
+   // ###################################################################################################################
+
+   bool eliminated = true;
+   while( eliminated )
+   {
+      eliminated = false;
+
+      vector<int> bins;
+      for( int j = 0; j < m; ++j )
+      {
+         if( size[j] > 0 )
+            bins.push_back(j);
+      }
+      stable_sort(bins.begin(), bins.end(), [&load](int a, int b) { return load[a] < load[b]; });
+
+      for( int e : bins )
+      {
+         vector<int> items;
+         for( int i : order ) // by decreasing weight
+         {
+            if( bin_of_item[i] == e )
+               items.push_back(i);
+         }
+
+         // move the items tentatively, undo all moves, if one item does not fit
+         vector<W>   savedLoad = load;
+         vector<int> savedSize = size;
+         bool        moved     = true;
+         for( int i : items )
+         {
+            int j = bestFit(weight[i], e);
+            if( j == -1 )
+            {
+               moved = false;
+               break;
+            }
+            bin_of_item[i] = j;
+            load[j] += weight[i];
+            ++size[j];
+         }
+
+         if( moved )
+         {
+            load[e]    = 0;
+            size[e]    = 0;
+            eliminated = true;
+            break;
+         }
+
+         load = savedLoad;
+         size = savedSize;
+         for( int i : items )
+         {
+            bin_of_item[i] = e;
+         }
+      }
+   }
+
+   return (int) count_if(size.begin(), size.end(), [](int s) { return s > 0; });
+}
+
+/**
+ * @brief pass a packing to SCIP
+ *
+ * @note The bins are relabeled in the order of their smallest item (see CompactModel::addStartSolution()). The packing
+ * is an original solution, i.e. its values are set on the original variables X_ij and Y_j and it is checked against
+ * the original problem: presolving may have fixed or multi-aggregated their transformed variables, which have no
+ * value of their own in a transformed solution.
+ */
+SCIP_RETCODE HeurRounding::submit(SCIP* scip, SCIP_HEUR* heur, const vector<int>& bin_of_item, SCIP_Bool* stored)
+{
+   SCIP_SOL* sol;
+   SCIP_CALL(SCIPcreateOrigSol(scip, &sol, heur));
+
+   vector<int> label(_var_Y.size(), -1);
+   int         nbLabels = 0;
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( bin_of_item[i] == -1 )
+         continue;
+
+      int& j = label[bin_of_item[i]];
+      if( j == -1 )
+         j = nbLabels++;
+
+      SCIP_CALL(SCIPsetSolVal(scip, sol, _var_X[_var_X_begin[i] + j], 1.0));
+   }
+
+   for( int j = 0; j < nbLabels; ++j )
+   {
+      SCIP_CALL(SCIPsetSolVal(scip, sol, _var_Y[j], 1.0));
+   }
+
+   SCIP_CALL(SCIPtrySolFree(scip, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, stored));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief round the LP solution of the current node
+ */
+SCIP_DECL_HEUREXEC(HeurRounding::scip_exec)
+{
+   *result = SCIP_DIDNOTRUN;
+
+   if( !SCIPhasCurrentNodeLP(scip) || SCIPgetLPSolstat(scip) != SCIP_LPSOLSTAT_OPTIMAL )
+      return SCIP_OKAY;
+
+   *result = SCIP_DIDNOTFIND;
+
+   vector<double> lpValue(_var_X.size());
+   for( size_t k = 0; k < _var_X.size(); ++k )
+   {
+      lpValue[k] = SCIPgetSolVal(scip, NULL, _var_X[k]);
+   }
+
+   vector<int> bin_of_item;
+   int nbBins = _ins->_integral ? round(_ins->int_w, _ins->int_b, lpValue, bin_of_item)
+                                : round(_ins->par_w, _ins->par_b, lpValue, bin_of_item);
+
+   if( nbBins == -1 || nbBins >= SCIPgetUpperbound(scip) - 0.5 )
+      return SCIP_OKAY;
+
+   SCIP_Bool stored;
+   SCIP_CALL(submit(scip, heur, bin_of_item, &stored));
+
+   if( stored )
+   {
+      ++_nbSolutions;
+      *result = SCIP_FOUNDSOL;
+   }
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,61 @@
+// HeurRounding.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief primal heuristic for the compact model, which rounds the LP solution of a node into a packing
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _var_X, _var_X_begin, _var_Y (original) variables of the compact model, see CompactModel
+ *
+ * @param _nbSolutions number of improving packings found
+ *
+ * @note LP-guided Best-Fit: the items are packed by decreasing weight. Every item is packed into the bin with the
+ * largest LP value X_ij, which still has enough residual capacity. If no bin of the LP support fits, the item is packed
+ * by Best-Fit into a used bin or into a new bin. The packing is then improved by a bin-elimination local search: the
+ * used bins are visited by increasing load, and a bin is emptied, if all its items can be moved into the other bins by
+ * Best-Fit. The search is repeated, until no bin can be eliminated. The packing is only passed to SCIP, if it needs
+ * fewer bins than the incumbent. As in CompactModel::addStartSolution(), the bins are relabeled in the order of their
+ * smallest item, so the packing is also feasible for the symmetry-broken formulation. Items, whose variables are all
+ * fixed to 0 (removed items, see CompactModel::removeItem()), are not packed. The heuristic is called after the LP of
+ * a node is solved, every freq-th depth of the tree.
+ */
+class HeurRounding : public ObjHeur
+{
+public:
+   // constructor
+   HeurRounding(SCIP*                    scip,
+                Instance*                ins,
+                const vector<SCIP_VAR*>& var_X,
+                const vector<int>&       var_X_begin,
+                const vector<SCIP_VAR*>& var_Y,
+                int                      freq);
+
+   // destructor
+   virtual ~HeurRounding() {}
+
+   virtual SCIP_DECL_HEUREXEC(scip_exec);
+
+   long long _nbSolutions; // number of improving packings found
+
+private:
+   // LP-guided Best-Fit and bin elimination, returns the number of used bins, -1 if the bins of the model do not suffice
+   template <typename W>
+   int round(const vector<W>& weight, W capacity, const vector<double>& lpValue, vector<int>& bin_of_item);
+
+   // pass a packing to SCIP
+   SCIP_RETCODE submit(SCIP* scip, SCIP_HEUR* heur, const vector<int>& bin_of_item, SCIP_Bool* stored);
+
+   Instance* _ins; // pointer to the instance
+
+   const vector<SCIP_VAR*>& _var_X;       // X_ij of the compact model, X_ij at position _var_X_begin[i] + j
+   const vector<int>&       _var_X_begin; // first position of the variables of item i in _var_X
+   const vector<SCIP_VAR*>& _var_Y;       // Y_j of the compact model
+};
@@ -0,0 +1,149 @@
+// Heuristic.cpp
+#include "Heuristic.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Construct a new Heuristic:: Heuristic object
+ *
+ * @param ins pointer to problem-instance
+ */
+Heuristic::Heuristic(Instance* ins)
+{
+   _ins        = ins;
+   _feasible   = false;
+   _nbBinsUsed = 0;
+}
+
+/**
+ * @brief pack the items in the given order into bins
+ *
+ * @param order order in which the items are packed
+ *
+ * @param bestFit false: First-Fit, true: Best-Fit
+ *
+ * @param weight weight of every item, as integers for integral instances
+ *
+ * @param capacity capacity of a bin
+ *
+ * @param bin_of_item returns the bin of every item
+ *
+ * @param load returns the load of every used bin
+ *
+ * @note Every item is packed into the first (First-Fit) or the fullest (Best-Fit) used bin, which still has enough
+ * residual capacity. If there is no such bin, a new bin is opened. The loads are summed up in the weight type, the
+ * capacity check is exact for integers and has a small tolerance for fractional weights (see fits()).
+ */
+template <typename W>
+void Heuristic::pack(const vector<int>& order,
+                     bool               bestFit,
+                     const vector<W>&   weight,
+                     W                  capacity,
+                     vector<int>&       bin_of_item,
+                     vector<double>&    load)
+{
+   bin_of_item.assign(_ins->_nbItems, -1);
+
+   vector<W> binLoad;
+
+   for( int i : order )
+   {
+      int chosen = -1;
+
+      for( int j = 0; j < (int) binLoad.size(); ++j )
+      {
+         if( !fits(binLoad[j], weight[i], capacity) )
+            continue;
+
+         if( chosen == -1 || (bestFit && binLoad[j] > binLoad[chosen]) )
+            chosen = j;
+
+         if( !bestFit )
+            break;
+      }
+
+      // open a new bin
+      if( chosen == -1 )
+      {
+         chosen = (int) binLoad.size();
+         binLoad.push_back(0);
+      }
+
+      bin_of_item[i] = chosen;
+      binLoad[chosen] += weight[i];
+   }
+
+   load.assign(binLoad.begin(), binLoad.end());
+}
+
+/**
+ * @brief run First-Fit-Decreasing and Best-Fit-Decreasing
+ *
+ * @note The items are sorted once by decreasing weight, then both heuristics are run and the packing with fewer bins is
+ * kept. If one item does not fit into an empty bin, the instance is infeasible and no packing is stored.
+ */
+void Heuristic::run()
+{
+   _feasible = true;
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( _ins->par_w[i] > _ins->par_b )
+         _feasible = false;
+   }
+
+   if( !_feasible )
+      return;
+
+   // sort the items by decreasing weight
+   vector<int> order(_ins->_nbItems);
+   iota(order.begin(), order.end(), 0);
+   stable_sort(order.begin(), order.end(), [this](int a, int b) { return _ins->par_w[a] > _ins->par_w[b]; });
+
+   vector<int>    bin_of_item;
+   vector<double> load;
+
+   withWeights(_ins,
+               [&](const auto& weight, auto capacity)
+               {
+                  // First-Fit-Decreasing
+                  pack(order, false, weight, capacity, _bin_of_item, _load);
+
+                  // Best-Fit-Decreasing, keep it if it needs fewer bins
+                  pack(order, true, weight, capacity, bin_of_item, load);
+                  return 0;
+               });
+
+   if( load.size() < _load.size() )
+   {
+      _bin_of_item = bin_of_item;
+      _load        = load;
+   }
+
+   _nbBinsUsed = (int) _load.size();
+}
+
+/**
+ * @brief display the packing of the heuristic
+ */
+void Heuristic::display()
+{
+   if( !_feasible )
+   {
+      cout << "Heuristic: no feasible packing" << endl;
+      return;
+   }
+
+   cout << "Heuristic: " << _nbBinsUsed << " bins" << endl;
+   for( int j = 0; j < _nbBinsUsed; ++j )
+   {
+      cout << "bin " << j << " (load " << _load[j] << "):";
+      for( int i = 0; i < _ins->_nbItems; ++i )
+      {
+         if( _bin_of_item[i] == j )
+            cout << " " << i;
+      }
+      cout << endl;
+   }
+}
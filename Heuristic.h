@@ -0,0 +1,52 @@
+// Heuristic.h
+#pragma once
+
+#include "Instance.h"
+
+/**
+ * @brief construction heuristics First-Fit-Decreasing and Best-Fit-Decreasing for the BPP
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _nbBinsUsed number of bins used by the best packing found
+ *
+ * @param _bin_of_item bin j \in J of every item i \in I in the best packing found
+ *
+ * @param _load load of every used bin in the best packing found
+ *
+ * @note Both heuristics sort the items by decreasing weight. First-Fit packs every item into the first bin, which has
+ * enough residual capacity, Best-Fit into the bin with the smallest sufficient residual capacity. A new bin is only
+ * opened, if no used bin fits. The better of both packings is an upper bound on the number of bins. It is used to
+ * reduce the set of bins J (_nbBins) before a model is built and as a starting solution for SCIP. For integral
+ * instances the loads are computed in integers (see withWeights()), so the capacity checks are exact. If an item is
+ * heavier than the capacity, there is no feasible packing and _feasible is false.
+ */
+class Heuristic
+{
+public:
+   // constructor
+   Heuristic(Instance* ins);
+
+   // run First-Fit-Decreasing and Best-Fit-Decreasing and keep the better packing
+   void run();
+
+   // display the packing
+   void display();
+
+   bool           _feasible;    // true, if a feasible packing was found
+   int            _nbBinsUsed;  // number of used bins in the best packing
+   vector<int>    _bin_of_item; // bin of every item i \in I, dimension: _nbItems
+   vector<double> _load;        // load of every used bin, dimension: _nbBinsUsed
+
+private:
+   // pack all items in the given order by First-Fit (bestFit = false) or Best-Fit (bestFit = true)
+   template <typename W>
+   void pack(const vector<int>& order,
+             bool               bestFit,
+             const vector<W>&   weight,
+             W                  capacity,
+             vector<int>&       bin_of_item,
+             vector<double>&    load);
+
+   Instance* _ins; // pointer to the instance
+};
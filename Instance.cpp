@@ -1,77 +1,467 @@
 #include "Instance.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
 /**
- * @brief read data from a .bpp-file
+ * @brief read-only memory mapping of a whole file
  *
- * @param nameFile path to bpp.file
+ * @note The file is mapped with MAP_PRIVATE and the kernel is told, that it is read sequentially. The mapping is
+ * removed by the destructor. An empty file has no mapping, begin == end.
+ */
+class MappedFile
+{
+public:
+   MappedFile(const string& nameFile)
+   {
+      int fd = open(nameFile.c_str(), O_RDONLY);
+      if( fd < 0 )
+         return;
+
+      struct stat st;
+      if( fstat(fd, &st) == 0 )
+      {
+         _ok   = true;
+         _size = (size_t) st.st_size;
+
+         if( _size > 0 )
+         {
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if( data == MAP_FAILED )
+            {
+               _ok   = false;
+               _size = 0;
+            }
+            else
+            {
+               madvise(data, _size, MADV_SEQUENTIAL);
+               _data = (const char*) data;
+            }
+         }
+      }
+      close(fd);
+   }
+
+   ~MappedFile()
+   {
+      if( _data != nullptr )
+         munmap((void*) _data, _size);
+   }
+
+   bool        _ok   = false;   // true, if the file could be opened and mapped
+   const char* _data = nullptr; // first character of the file
+   size_t      _size = 0;       // size of the file in bytes
+};
+
+/**
+ * @brief tokenizer on the mapped file, which keeps track of the current line for error messages
  *
- * @note This function reads data from a .bpp-file and stores it in the instance. It takes in a string nameFile which is
- * the path to the bpp.file. The function uses an ifstream to open the file and checks if it is valid. If not, an error
- * message is printed. The function then reads each line of the file and stores it in a string line. A character
- * par_name is set to 0 and ss (an istringstream) reads the first character of the line. A switch statement is used
- * to determine which parameter to store the data in based on the first character of each line. The
- * _nbItems-parameter is used to resize the par_w vector to fit the number of items. The _nbBins-parameter is used to
- * specify the upper bound of available bins. In our case it is equivalent to _nbItems. The data is then stored in
- * vector par_w (weights of items) and scalar par_b (capacity of a single bin) depending on what type of data it is.
- * Every line is loaded into ss and with >> we can get the next character from ss and delete it from ss. Finally, the
- * file stream is closed.
+ * @note Tokens are views into the mapped file, nothing is copied or allocated. Numbers are converted with
+ * std::from_chars, a token is only accepted as a number, if it is consumed completely.
  */
-void Instance::read(string nameFile)
+class Parser
 {
-   ifstream infile(nameFile);
-   if( !infile ) //! warning, if file-path is wrong, pay attention, the code will not stop!
-      cout << "Instance::read : file not found"
-           << "\n";
+public:
+   Parser(const string& nameFile, const char* begin, const char* end)
+       : _nameFile(nameFile), _pos(begin), _end(end)
+   {
+   }
+
+   // true, if there is no token left
+   bool atEnd()
+   {
+      skipSpace(true);
+      return _pos == _end;
+   }
+
+   // the next token, crossing line breaks if newLine is true, an empty token if there is none
+   string_view nextToken(bool newLine)
+   {
+      skipSpace(newLine);
+      const char* start = _pos;
+      while( _pos != _end && !isspace((unsigned char) *_pos) )
+         ++_pos;
+      return string_view(start, _pos - start);
+   }
+
+   // skip the rest of the current line
+   void skipLine()
+   {
+      while( _pos != _end && *_pos != '\n' )
+         ++_pos;
+   }
 
-   string line; // a string, which stores a single line
+   // convert the complete token into a number, nan and inf are no numbers
+   template <typename T>
+   bool toNumber(string_view token, T& value)
+   {
+      if( token.empty() )
+         return false;
+      const char* first = token.data();
+      if( *first == '+' )
+         ++first;
+      auto [ptr, ec] = from_chars(first, token.data() + token.size(), value);
+      if( ec != errc() || ptr != token.data() + token.size() )
+         return false;
+      if constexpr( is_floating_point_v<T> )
+         return isfinite(value);
+      return true;
+   }
 
-   while( getline(infile, line) ) // do this for every line in the file, if there is any
+   // read the next token as a number, print an error if it is missing or no number
+   template <typename T>
+   bool nextNumber(T& value, const char* what, bool newLine = true)
    {
-      istringstream ss(line); // ss is a string stream of the line, which makes it possible to get different
-                              // strings separated by spaces
+      string_view token = nextToken(newLine);
+      if( toNumber(token, value) )
+         return true;
+      if( token.empty() )
+         return error(string("missing ") + what);
+      return error(string("invalid ") + what + " '" + string(token) + "'");
+   }
 
-      char par_name = {0}; // the first character of the line, which indicates the parameter, initialized with 0
+   // print an error message with file name and line, always returns false
+   bool error(const string& message)
+   {
+      cerr << "Instance::read : " << _nameFile << ":" << _line << ": " << message << "\n";
+      return false;
+   }
 
-      ss >> par_name; // get the first char of the line
+   int _line = 1; // current line, starting with 1
 
-      switch( par_name ) // Instead of using multiple if-statements, we use a switch statement: if(par_name == '')
+private:
+   // skip white space, stop at a line break if newLine is false
+   void skipSpace(bool newLine)
+   {
+      while( _pos != _end && isspace((unsigned char) *_pos) )
       {
-      case 'I': // read number of items and therefore bins
+         if( *_pos == '\n' )
+         {
+            if( !newLine )
+               return;
+            ++_line;
+         }
+         ++_pos;
+      }
+   }
+
+   const string& _nameFile; // name of the file, for error messages
+   const char*   _pos;      // current position in the file
+   const char*   _end;      // end of the file
+};
+
+/**
+ * @brief parse an instance file and pass every weight to a sink
+ *
+ * @param nameFile path to the file
+ *
+ * @param capacity returns the capacity b
+ *
+ * @param nbItems returns the number of items, it is set before the first weight and corrected at the end (item types)
+ *
+ * @param capacityFirst true: the capacity has to be known before the first weight, so the sink can use it
+ *
+ * @param sink callable sink(int item, double weight), called once for every item i \in I
+ *
+ * @return true, if the file was read, false if the file is missing or malformed
+ *
+ * @note This function maps the file into memory and parses it without copying a line: every token is a view into the
+ * mapping and numbers are converted with std::from_chars. The format is detected from the first token:
+ * - own format: every line starts with a key character. 'I' sets the number of items, 'b' sets the capacity and 'w'
+ *   sets the weight of item i. Lines with any other key (e.g. 'p' for comments) are ignored.
+ * - BPPLIB / Scholl format: the number of items n, the capacity and then either n weights or n pairs of weight and
+ *   multiplicity (item types), which are expanded into single items.
+ * - OR-Library format of the Falkenauer instances: the number of instances, the name of the instance, the capacity,
+ *   the number of items, the best known number of bins and the weights. Only the first instance of the file is read.
+ * A missing file, a missing or invalid number, an item index out of range, a missing weight, a non-positive capacity
+ * or a negative weight is reported with file name and line on cerr and the function returns false. The weights are
+ * checked, before they are passed to the sink.
+ */
+template <typename SINK>
+bool parseInstance(const string& nameFile, double& capacity, int& nbItems, bool capacityFirst, SINK&& sink)
+{
+   nbItems  = 0;
+   capacity = 0;
+
+   MappedFile file(nameFile);
+   if( !file._ok )
+   {
+      cerr << "Instance::read : file not found: " << nameFile << "\n";
+      return false;
+   }
+
+   Parser parser(nameFile, file._data, file._data + file._size);
+
+   if( parser.atEnd() )
+      return parser.error("empty file");
+
+   // detect the format by the first token
+   Parser      lookahead = parser;
+   string_view first     = lookahead.nextToken(true);
+   string_view second    = lookahead.nextToken(true);
+   double      number;
+
+   if( !parser.toNumber(first, number) )
+   {
+      //##################################################################################################################
+      // own format: key character at the beginning of every line
+      vector<bool> hasWeight;
+      bool         hasCapacity = false;
+
+      while( !parser.atEnd() )
       {
-         int parameter;
-         ss >> parameter;
+         string_view key = parser.nextToken(true);
 
-         // set _nbItems and _nbBins
-         _nbItems = parameter;
-         _nbBins  = parameter;
+         switch( key.size() == 1 ? key[0] : 0 )
+         {
+         case 'I': // read number of items and therefore bins
+         {
+            if( !parser.nextNumber(nbItems, "number of items", false) )
+               return false;
+            if( nbItems < 0 )
+               return parser.error("negative number of items");
 
-         // as par_w depends on the number of items, we are resizing them
-         par_w.resize(_nbItems, 0);
+            hasWeight.assign(nbItems, false);
+            break;
+         }
 
-         break; // jump to the end of the switch-statement
+         case 'b': // read b : bin capacity parameter
+         {
+            if( !parser.nextNumber(capacity, "capacity", false) )
+               return false;
+            if( capacity <= 0 )
+               return parser.error("the capacity must be positive");
+            hasCapacity = true;
+            break;
+         }
+
+         case 'w': // read w_i: weight for item i
+         {
+            int    item;
+            double weight;
+            if( !parser.nextNumber(item, "item index", false) )
+               return false;
+            if( item < 0 || item >= nbItems )
+               return parser.error("item index " + to_string(item) + " out of range (missing or too small 'I'?)");
+            if( !parser.nextNumber(weight, "weight", false) )
+               return false;
+            if( weight < 0 )
+               return parser.error("negative weight of item " + to_string(item));
+            if( capacityFirst && !hasCapacity )
+               return parser.error("the capacity 'b' must be given before the weights");
+            if( hasWeight[item] )
+               return parser.error("repeated weight of item " + to_string(item));
+            sink(item, weight);
+            hasWeight[item] = true;
+            break;
+         }
+
+            // if no of the key-chars is at the beginning, ignore the whole line and do nothing
+         }
+
+         parser.skipLine();
       }
 
-      case 'b': // read b : bin capacity parameter
+      if( !hasCapacity )
+         return parser.error("missing capacity 'b'");
+
+      for( int i = 0; i < nbItems; ++i )
       {
-         double val;
-         ss >> val;
-         par_b = val;
-         break;
+         if( !hasWeight[i] )
+            return parser.error("missing weight of item " + to_string(i));
       }
-
-      case 'w': // read w_i: weight for item i
+   }
+   else
+   {
+      //##################################################################################################################
+      // BPPLIB / Scholl or OR-Library (Falkenauer) format: only numbers, separated by white space
+      if( !second.empty() && !parser.toNumber(second, number) )
       {
-         int item;
-         double weight;
-         ss >> item >> weight;
-         par_w[item] = weight;
-         break;
+         // OR-Library: number of instances, name, capacity, number of items, best known number of bins
+         int nbInstances;
+         int best;
+         if( !parser.nextNumber(nbInstances, "number of instances") )
+            return false;
+         parser.nextToken(true); // name of the instance
+         if( !parser.nextNumber(capacity, "capacity") || !parser.nextNumber(nbItems, "number of items") ||
+             !parser.nextNumber(best, "best known number of bins") )
+            return false;
+         if( capacity <= 0 )
+            return parser.error("the capacity must be positive");
+         if( nbItems < 0 )
+            return parser.error("negative number of items");
+
+         for( int i = 0; i < nbItems; ++i )
+         {
+            double weight;
+            if( !parser.nextNumber(weight, "weight") )
+               return false;
+            if( weight < 0 )
+               return parser.error("negative weight of item " + to_string(i));
+            sink(i, weight);
+         }
       }
-      
-         // if no of the key-chars is at the beginning, ignore the whole line and do nothing
+      else
+      {
+         // BPPLIB / Scholl: number of items (or item types), capacity, weights (with multiplicities)
+         int nbLines;
+         if( !parser.nextNumber(nbLines, "number of items") || !parser.nextNumber(capacity, "capacity") )
+            return false;
+         if( nbLines < 0 )
+            return parser.error("negative number of items");
+         if( capacity <= 0 )
+            return parser.error("the capacity must be positive");
+
+         // the number of lines is the number of items, unless there are multiplicities
+         nbItems  = nbLines;
+         int item = 0;
+         for( int k = 0; k < nbLines; ++k )
+         {
+            double weight;
+            if( !parser.nextNumber(weight, "weight") )
+               return false;
+            if( weight < 0 )
+               return parser.error("negative weight of item " + to_string(item));
+
+            // an optional second number on the same line is the multiplicity of the weight
+            int         multiplicity = 1;
+            string_view token        = parser.nextToken(false);
+            if( !token.empty() && (!parser.toNumber(token, multiplicity) || multiplicity < 0) )
+               return parser.error("invalid multiplicity '" + string(token) + "'");
+
+            for( int m = 0; m < multiplicity; ++m )
+            {
+               sink(item++, weight);
+            }
+         }
+
+         nbItems = item;
+
+         if( !parser.atEnd() )
+            return parser.error("unexpected data after the last weight");
       }
    }
-   infile.close();
+
+   return true;
+}
+
+} // namespace
+
+/**
+ * @brief read data from a .bpp-file
+ *
+ * @param nameFile path to bpp.file
+ *
+ * @return true, if the instance was read, false if the file is missing or malformed
+ *
+ * @note The file is parsed by parseInstance(), which detects the format (own format, BPPLIB / Scholl or OR-Library)
+ * and reports malformed files with file name and line on cerr. The number of bins _nbBins is equivalent to _nbItems.
+ */
+bool Instance::read(const string& nameFile)
+{
+   par_w.clear();
+
+   bool read = parseInstance(nameFile,
+                             par_b,
+                             _nbItems,
+                             false,
+                             [this](int item, double weight)
+                             {
+                                // as par_w depends on the number of items, we are resizing them
+                                if( item >= (int) par_w.size() )
+                                   par_w.resize(max(item + 1, _nbItems), 0);
+                                par_w[item] = weight;
+                             });
+
+   if( !read )
+   {
+      _nbItems = 0;
+      _nbBins  = 0;
+      par_b    = 0;
+      par_w.clear();
+      return false;
+   }
+
+   par_w.resize(_nbItems);
+   _nbBins = _nbItems;
+
+   setIntegral();
+
+   return true;
+}
+
+/**
+ * @brief read the capacity and the number of items from a .bpp-file and pass the weights to a callback
+ *
+ * @param nameFile path to bpp.file
+ *
+ * @param item callback, which is called with the weight of every item i \in I in the order of the file
+ *
+ * @return true, if the instance was read, false if the file is missing or malformed
+ *
+ * @note The weights are not stored, par_w stays empty and _integral false, so the memory does not depend on the number
+ * of items (see StreamHeuristic). The capacity par_b is known, before the first weight is passed; in the own format,
+ * the line 'b' has to precede the lines 'w'. If the file is malformed, the callback may already have been called for
+ * some weights.
+ */
+bool Instance::stream(const string& nameFile, const function<void(double)>& item)
+{
+   par_w.clear();
+   int_w.clear();
+   int_b     = 0;
+   _integral = false;
+
+   bool read = parseInstance(nameFile, par_b, _nbItems, true, [&item](int, double weight) { item(weight); });
+
+   _nbBins = read ? _nbItems : 0;
+   return read;
+}
+
+/**
+ * @brief detect, if the capacity and all weights are integral, and store them as integers
+ *
+ * @note This function has to be called again, whenever par_b or par_w are changed. The integers are non-negative and
+ * limited to 2^53, so every integral double is represented exactly. The capacity plus the sum of all weights is limited
+ * to 2^58: every load, every sum of weights and the scaled sums of the dual feasible functions (at most 22 times the
+ * sum of all weights, see LowerBound::boundDFF()) stay below 2^63, so the integer arithmetic can not overflow.
+ */
+void Instance::setIntegral()
+{
+   const double    limit      = 9007199254740992.0; // 2^53
+   const long long limitTotal = 1LL << 58;
+
+   _integral       = par_b == floor(par_b) && par_b >= 0 && par_b <= limit;
+   long long total = _integral ? (long long) par_b : 0;
+   for( int i = 0; i < _nbItems && _integral; ++i )
+   {
+      // the total stays below 2^58 + 2^53 before the check, so the sum itself can not overflow
+      _integral = par_w[i] == floor(par_w[i]) && par_w[i] >= 0 && par_w[i] <= limit;
+      total += _integral ? (long long) par_w[i] : 0;
+      _integral = _integral && total < limitTotal;
+   }
+
+   int_w.clear();
+   int_b = 0;
+   if( !_integral )
+      return;
+
+   int_b = (long long) par_b;
+   int_w.resize(_nbItems);
+   for( int i = 0; i < _nbItems; ++i )
+   {
+      int_w[i] = (long long) par_w[i];
+   }
 }
 
 /**
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -18,20 +19,36 @@ using namespace std;
  * - set I: containing all item indices, starting with 0 and ending in _nbItems - 1,
  * - set J: containing all bin indices, starting with 0 and ending in _nbBins - 1,
  and two parameters: par_w and par_b. The read() function reads in a file with the parameter
- values, and the display() function displays the values.
+ values, and the display() function displays the values. Besides the own format (lines "I n", "b capacity",
+ "w i weight"), read() understands the BPPLIB / Scholl format (n, capacity, one weight or one weight and its
+ multiplicity per line) and the OR-Library format of the Falkenauer instances (the first instance of the file).
+ If the capacity and all weights are integral (and their sum is below 2^58, see setIntegral()), they are also stored
+ as integers (int_b, int_w) and _integral is true, so the heuristic and the solvers can use exact integer arithmetic
+ instead of comparisons with a tolerance (see Weights.h). For instances, which are too large to be stored, stream()
+ only keeps the capacity and the number of items and passes the weights one after the other to a callback.
  */
 class Instance
 {
 public:
-   int _nbItems; // Setsize of Items (i \in I)
-   int _nbBins;  // Setsize of Bins (j \in J)
+   int _nbItems = 0; // Setsize of Items (i \in I)
+   int _nbBins  = 0; // Setsize of Bins (j \in J)
 
    // Parameters
-   double         par_b; // b - capacity of a single bin
-   vector<double> par_w; // w_i - weight of item i \in I
-                        // dimension: _nbItems
+   double         par_b = 0; // b - capacity of a single bin
+   vector<double> par_w;     // w_i - weight of item i \in I
+                             // dimension: _nbItems
 
-   void read(string nameFile); // function to read data from a file
+   // integral parameters, only set if _integral is true
+   bool              _integral = false; // true, if b and all w_i are integral
+   long long         int_b     = 0;     // b as integer
+   vector<long long> int_w;             // w_i as integer, dimension: _nbItems
+
+   bool read(const string& nameFile); // function to read data from a file, false if the file is missing or malformed
+
+   // function to read b from a file and pass every w_i to a callback without storing it, false if the file is malformed
+   bool stream(const string& nameFile, const function<void(double)>& item);
 
    void display(); // function to display the data
+
+   void setIntegral(); // detect integral parameters and set int_b and int_w, call it after every change of b or w_i
 };
\ No newline at end of file
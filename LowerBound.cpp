@@ -0,0 +1,256 @@
+// LowerBound.cpp
+#include "LowerBound.h"
+#include "Reduction.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <map>
+#include <numeric>
+
+/**
+ * @brief Construct a new LowerBound:: LowerBound object
+ *
+ * @param ins pointer to problem-instance
+ */
+LowerBound::LowerBound(Instance* ins)
+{
+   _ins           = ins;
+   _L1            = 0;
+   _L2            = 0;
+   _L3            = 0;
+   _LDFF          = 0;
+   _best          = 0;
+   _maxRounds     = 10;
+   _maxThresholds = 100;
+   _maxK          = 10;
+}
+
+/**
+ * @brief bound L2 of Martello and Toth
+ *
+ * @param weight weights sorted by decreasing weight
+ *
+ * @param capacity capacity of a bin
+ *
+ * @return the maximum of the bounds of all thresholds k, which is at least ceil(sum of weights / capacity)
+ *
+ * @note Only the weights k <= capacity / 2 of the items and 0 are thresholds, as the bound only changes at these
+ * values. With the prefix sums of the sorted weights, the sizes and weights of the groups are found by binary search.
+ */
+long long LowerBound::boundL2(const vector<long long>& weight, long long capacity)
+{
+   if( capacity <= 0 )
+      return 0;
+
+   size_t            n = weight.size();
+   vector<long long> prefix(n + 1, 0);
+   for( size_t p = 0; p < n; ++p )
+   {
+      prefix[p + 1] = prefix[p] + weight[p];
+   }
+
+   // first position with a weight of at most the given value
+   auto position = [&weight](long long value)
+   { return (size_t) (lower_bound(weight.begin(), weight.end(), value, greater<long long>()) - weight.begin()); };
+
+   size_t    half = position(capacity / 2);
+   long long best = (prefix[n] + capacity - 1) / capacity;
+
+   for( size_t p = half; p <= n; ++p )
+   {
+      long long k = p < n ? weight[p] : 0;
+      if( p > half && p < n && weight[p - 1] == k )
+         continue;
+
+      size_t large = position(capacity - k); // items heavier than capacity - k before this position
+      size_t small = k > 0 ? position(k - 1) : n;
+
+      long long nb1   = (long long) large;
+      long long nb2   = (long long) (half - large);
+      long long sum2  = prefix[half] - prefix[large];
+      long long sum3  = prefix[small] - prefix[half];
+      long long free  = nb2 * capacity - sum2;
+      long long extra = sum3 > free ? (sum3 - free + capacity - 1) / capacity : 0;
+      best            = max(best, nb1 + nb2 + extra);
+   }
+
+   return best;
+}
+
+/**
+ * @brief bound L3 of Martello and Toth
+ *
+ * @note Every round reduces the current instance, adds its fixed bins to the bins fixed so far and evaluates L2 of the
+ * residual instance. The next round starts from the residual instance without its smallest item. Dropping an item can
+ * only decrease the optimal number of bins, and the fixed bins are part of an optimal packing, so the bound of every
+ * round is valid. The rounds stop after _maxRounds rounds or after a round without a fixed bin, as the reduction is the
+ * expensive part and rarely fixes bins again after a single item is dropped.
+ */
+int LowerBound::boundL3()
+{
+   long long best  = 0;
+   long long fixed = 0;
+
+   Instance* current = new Instance(*_ins);
+
+   for( int round = 0; round < _maxRounds && current->_nbItems > 0; ++round )
+   {
+      Reduction red(current);
+      Instance* residual = red.run();
+      fixed += red.nbFixedBins();
+      bool progress = red.nbFixedBins() > 0;
+
+      vector<long long> weight = residual->int_w;
+      sort(weight.begin(), weight.end(), greater<long long>());
+      best = max(best, fixed + boundL2(weight, residual->int_b));
+
+      // drop the smallest item of the residual instance
+      delete current;
+      current = new Instance(*residual);
+      if( current->_nbItems > 0 )
+      {
+         auto smallest = min_element(current->par_w.begin(), current->par_w.end());
+         current->par_w.erase(smallest);
+         current->_nbItems--;
+         current->_nbBins = current->_nbItems;
+         current->setIntegral();
+      }
+
+      if( !progress )
+         break;
+   }
+
+   delete current;
+
+   return (int) best;
+}
+
+/**
+ * @brief dual feasible function of Fekete and Schepers
+ *
+ * @param w weight, 0 <= w <= b
+ *
+ * @param b capacity, at most 2^31, so no product can overflow
+ *
+ * @param t threshold of U_t, 0 <= t <= b/2
+ *
+ * @param k parameter of u_k, 0: U_t alone
+ *
+ * @return u_k(U_t(w)) scaled to integers, dff(b, b, t, k) is the transformed capacity (b for k = 0, k b otherwise)
+ */
+long long LowerBound::dff(long long w, long long b, long long t, long long k)
+{
+   long long x = w > b - t ? b : (w < t ? 0 : w);
+   if( k == 0 )
+      return x;
+
+   return (k + 1) * x % b == 0 ? k * x : (k + 1) * x / b * b;
+}
+
+/**
+ * @brief best bound of the dual feasible functions
+ *
+ * @note The items are aggregated by weight, so every function is evaluated once per distinct weight. The functions are
+ * scaled by k, so all values are integers: u_k(x) = k x, if (k + 1) x is a multiple of b, and floor((k + 1) x / b) b
+ * otherwise, u_k(b) = k b. The composition with U_t alone (without u_k) is evaluated as well.
+ */
+int LowerBound::boundDFF()
+{
+   long long b = _ins->int_b;
+   if( b <= 0 || b > INT32_MAX )
+      return 0;
+
+   map<long long, long long> count; // number of items of every weight
+   for( long long w : _ins->int_w )
+   {
+      ++count[w];
+   }
+
+   vector<long long> threshold = {0};
+   for( const auto& [w, nb] : count )
+   {
+      if( w > 0 && 2 * w <= b )
+         threshold.push_back(w);
+   }
+
+   // keep evenly spaced thresholds, if there are too many
+   if( (int) threshold.size() > _maxThresholds )
+   {
+      vector<long long> sample;
+      for( int s = 0; s < _maxThresholds; ++s )
+      {
+         sample.push_back(threshold[(size_t) s * threshold.size() / _maxThresholds]);
+      }
+      threshold = sample;
+   }
+
+   long long best = 0;
+
+   for( long long t : threshold )
+   {
+      for( long long k = 0; k <= _maxK; ++k )
+      {
+         long long sum = 0;
+         for( const auto& [w, nb] : count )
+         {
+            sum += nb * dff(w, b, t, k);
+         }
+         long long ub = dff(b, b, t, k);
+         best         = max(best, (sum + ub - 1) / ub);
+      }
+   }
+
+   return (int) best;
+}
+
+/**
+ * @brief compute the bounds
+ *
+ * @param upperBound number of bins of a known packing, e.g. of the heuristic
+ *
+ * @note The bounds are computed from the cheapest to the most expensive one, L1, L2, DFF and L3, and the computation
+ * stops, as soon as the best bound reaches the upper bound, the bounds, which are not computed, are 0. L1 of
+ * fractional weights allows a small tolerance, so rounding errors in the sum do not add a bin.
+ */
+void LowerBound::run(int upperBound)
+{
+   if( !_ins->_integral )
+   {
+      double total = accumulate(_ins->par_w.begin(), _ins->par_w.end(), 0.0);
+      _L1          = _ins->par_b > 0 ? (int) ceil(total / _ins->par_b - 1e-9) : 0;
+      _L2          = _L1;
+      _L3          = _L1;
+      _LDFF        = _L1;
+      _best        = _L1;
+      return;
+   }
+
+   long long b     = _ins->int_b;
+   long long total = accumulate(_ins->int_w.begin(), _ins->int_w.end(), 0LL);
+   _L1             = b > 0 ? (int) ((total + b - 1) / b) : 0;
+
+   vector<long long> weight = _ins->int_w;
+   sort(weight.begin(), weight.end(), greater<long long>());
+   _L2   = (int) boundL2(weight, b);
+   _best = max(_L1, _L2);
+   if( _best >= upperBound )
+      return;
+
+   _LDFF = boundDFF();
+   _best = max(_best, _LDFF);
+   if( _best >= upperBound )
+      return;
+
+   _L3   = boundL3();
+   _best = max(_best, _L3);
+}
+
+/**
+ * @brief display the bounds
+ */
+void LowerBound::display()
+{
+   cout << "Lower bounds: L1 " << _L1 << ", L2 " << _L2 << ", L3 " << _L3 << ", DFF " << _LDFF << ", best " << _best
+        << endl;
+}
@@ -0,0 +1,65 @@
+// LowerBound.h
+#pragma once
+
+#include "Instance.h"
+
+#include <climits>
+
+/**
+ * @brief lower bounds on the number of bins, which are computed on the instance without a model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _L1, _L2, _L3, _LDFF the single bounds, _best the maximum of all bounds
+ *
+ * @note L1 is the continuous bound ceil(sum of weights / b). The other bounds need an integral capacity and integral
+ * weights (see Instance::setIntegral()), otherwise they are equal to L1:
+ * - L2 of Martello and Toth: for a threshold k <= b/2, the items heavier than b - k and the items in (b/2, b - k] need
+ *   a bin each, the items in [k, b/2] can only use the residual capacity of the bins of the second group or new bins.
+ *   The weights are sorted once, so every threshold is evaluated by binary searches on the prefix sums.
+ * - L3 of Martello and Toth: the reduction (see Reduction) fixes bins of an optimal packing, L2 of the residual
+ *   instance plus the fixed bins is a bound. Then the smallest item is dropped (a relaxation) and the reduction is
+ *   repeated on the rest, at most _maxRounds times and only as long as it fixes bins.
+ * - dual feasible functions of Fekete and Schepers: a function u with u(x) + u(y) <= u(b) for x + y <= b maps every
+ *   packing to a packing of the transformed weights, so ceil(sum u(w_i) / u(b)) is a bound. The functions are the
+ *   compositions of U_t (weights below t become 0, weights above b - t become b) and u_k (the weight is rounded down
+ *   to a multiple of b / k, unless (k + 1) w / b is integral), for every item weight t <= b/2 as threshold (at most
+ *   _maxThresholds of them) and k = 1, ..., _maxK. They need a capacity below 2^31, so no sum can overflow.
+ */
+class LowerBound
+{
+public:
+   // constructor
+   LowerBound(Instance* ins);
+
+   // compute the bounds, stop as soon as the best bound reaches the upper bound
+   void run(int upperBound = INT_MAX);
+
+   // display the bounds
+   void display();
+
+   // bound L2 of Martello and Toth for weights sorted by decreasing weight
+   static long long boundL2(const vector<long long>& weight, long long capacity);
+
+   // dual feasible function u_k(U_t(w)), scaled to integers, k = 0: U_t alone
+   static long long dff(long long w, long long b, long long t, long long k);
+
+   int _L1;   // continuous bound
+   int _L2;   // bound L2 of Martello and Toth
+   int _L3;   // bound L3 of Martello and Toth
+   int _LDFF; // best bound of the dual feasible functions
+   int _best; // maximum of all bounds
+
+private:
+   // bound L3 of Martello and Toth
+   int boundL3();
+
+   // best bound of the dual feasible functions
+   int boundDFF();
+
+   Instance* _ins; // pointer to the instance
+
+   int _maxRounds;     // maximal number of reductions of L3
+   int _maxThresholds; // maximal number of thresholds t of the dual feasible functions
+   int _maxK;          // maximal parameter k of the dual feasible functions
+};
@@ -0,0 +1,282 @@
+// PatternModel.cpp
+#include "PatternModel.h"
+#include "BranchRyanFoster.h"
+#include "ConsSameDiff.h"
+#include "PatternVardata.h"
+#include "PricerKnapsack.h"
+
+/**
+ * @brief Construct a new Pattern Model:: Pattern Model object
+ *
+ * @param ins pointer to problem-instance
+ *
+ * @note This code is a constructor for the PatternModel class. It creates a SCIP environment, includes the
+ * problem-specific plugins (same/differ constraint handler, Ryan-Foster branching rule, knapsack pricer) and sets the
+ * specific parameters. It then creates the item covering constraints and a starting set of patterns, one for every
+ * item, which fits into a bin. Items, which are heavier than the capacity, are not covered by any pattern, so the
+ * Farkas pricing proves the infeasibility of the instance.
+ */
+PatternModel::PatternModel(Instance* ins)
+{
+   _ins = ins; // initialize the private pointer variable to the instance object
+
+   // create a SCIP environment and load all defaults
+   SCIPcreate(&_scipPM);
+   SCIPincludeDefaultPlugins(_scipPM);
+
+   // include the branch-and-price plugins, SCIP frees them together with the environment
+   SCIPincludeObjConshdlr(_scipPM, new ConsSameDiff(_scipPM), TRUE);
+   SCIPincludeObjBranchrule(_scipPM, new BranchRyanFoster(_scipPM, _ins), TRUE);
+
+   // create an empty model
+   SCIPcreateProbBasic(_scipPM, "Pattern Model BPP");
+
+   // set the objective sense to minimize (not mandatory, default is minimize)
+   SCIPsetObjsense(_scipPM, SCIP_OBJSENSE_MINIMIZE);
+
+   // every pattern costs 1, so the objective value is always integral
+   SCIPsetObjIntegral(_scipPM);
+
+   // call the created function set all optional SCIPParameters
+   setSCIPParameters();
+
+   // create helping-dummy for the name of variables and constraints
+   char var_cons_name[255];
+
+   // #####################################################################################################################
+   //  Add restrictions
+   // #####################################################################################################################
+
+   // sum(p in P: i in p, lambda_p) >= 1 for all i in I
+   // the constraints are modifiable, as the pricer adds new patterns to them
+
+   _cons_item_covering.resize(_ins->_nbItems, nullptr);
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      SCIPsnprintf(var_cons_name, 255, "item_covering_%d", i);
+
+      SCIPcreateConsBasicLinear(_scipPM,                  // scip
+                                &_cons_item_covering[i], // cons
+                                var_cons_name,           // name
+                                0,                       // nvar
+                                0,                       // vars
+                                0,                       // coeffs
+                                1,                       // lhs
+                                SCIPinfinity(_scipPM));  // rhs
+
+      SCIPsetConsModifiable(_scipPM, _cons_item_covering[i], TRUE);
+      SCIPaddCons(_scipPM, _cons_item_covering[i]);
+   }
+
+   // #####################################################################################################################
+   //  Create and add the initial patterns
+   // #####################################################################################################################
+
+   // one pattern {i} for every item i, which fits into a bin
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( _ins->par_w[i] > _ins->par_b )
+         continue;
+
+      SCIP_VAR* var;
+
+      SCIPsnprintf(var_cons_name, 255, "pattern_%d", i);
+
+      SCIPcreateObjVar(_scipPM,
+                       &var,
+                       var_cons_name,                // name
+                       0,                            // lower bound
+                       1,                            // upper bound
+                       1,                            // objective function coefficient: every used bin costs 1
+                       SCIP_VARTYPE_BINARY,          // variable type
+                       TRUE,                         // initial
+                       FALSE,                        // removable
+                       new PatternVardata({i}),      // variable data: the items of the pattern
+                       TRUE);                        // delete the variable data together with the variable
+
+      SCIPchgVarUbLazy(_scipPM, var, 1.0); // the upper bound is only added to the LP if it is violated
+      SCIPaddVar(_scipPM, var);
+      SCIPaddCoefLinear(_scipPM, _cons_item_covering[i], var, 1);
+
+      _var_lambda.push_back(var);
+   }
+
+   // #####################################################################################################################
+   //  Include and activate the pricer
+   // #####################################################################################################################
+
+   SCIPincludeObjPricer(_scipPM, new PricerKnapsack(_scipPM, _ins, _cons_item_covering), TRUE);
+   SCIPactivatePricer(_scipPM, SCIPfindPricer(_scipPM, "knapsack"));
+}
+
+/**
+ * @brief Destroy the Pattern Model:: Pattern Model object
+ *
+ * @note This is the destructor for the Pattern Model class. It releases all item covering constraints and all initial
+ * pattern variables, and then frees the SCIP object. The priced variables are released by the pricer directly after
+ * they were added, the plugins are freed by SCIP.
+ */
+PatternModel::~PatternModel()
+{
+   // release all item covering constraints
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      SCIPreleaseCons(_scipPM, &_cons_item_covering[i]);
+   }
+
+   // release all initial pattern variables
+   for( size_t p = 0; p < _var_lambda.size(); ++p )
+   {
+      SCIPreleaseVar(_scipPM, &_var_lambda[p]);
+   }
+
+   // At the end release the SCIP object itself
+   SCIPfree(&_scipPM);
+}
+
+/**
+ * @brief set optional SCIP parameters
+ *
+ * @note This function sets optional SCIP parameters for the PatternModel object. Besides the limits of the compact
+ * model, restarts are forbidden (a restart would remove the priced variables) and the separation is turned off, because
+ * cuts would change the structure of the pricing problem. For more information on these parameters, please refer to
+ * the SCIP documentation at https://www.scipopt.org/doc/html/PARAMETERS.php.
+ */
+void PatternModel::setSCIPParameters()
+{
+   SCIPsetRealParam(_scipPM, "limits/time", 1e+20);          // default 1e+20 s
+   SCIPsetRealParam(_scipPM, "limits/gap", 0);               // default 0
+   SCIPsetIntParam(_scipPM, "display/verblevel", 4);         // default 4
+   SCIPsetBoolParam(_scipPM, "display/lpinfo", FALSE);       // default FALSE
+   SCIPsetIntParam(_scipPM, "presolving/maxrestarts", 0);    // default -1
+   SCIPsetSeparating(_scipPM, SCIP_PARAMSETTING_OFF, TRUE);  // no cutting planes in the master problem
+};
+
+/**
+ * @brief add the bins of the heuristic as patterns and pass the packing to SCIP as a starting solution
+ *
+ * @param heur pointer to the heuristic, which has already been run
+ *
+ * @note Every bin of the heuristic packing becomes an initial pattern variable, so the first master LP already
+ * contains good columns. The solution with lambda_p = 1 for exactly these patterns is passed to SCIP. It has to be
+ * called before solve().
+ */
+void PatternModel::addStartSolution(Heuristic* heur)
+{
+   if( !heur->_feasible )
+      return;
+
+   char              var_name[255];
+   vector<SCIP_VAR*> heurVars;
+
+   for( int j = 0; j < heur->_nbBinsUsed; ++j )
+   {
+      vector<int> items;
+      for( int i = 0; i < _ins->_nbItems; ++i )
+      {
+         if( heur->_bin_of_item[i] == j )
+            items.push_back(i);
+      }
+
+      // a bin with a single item is already an initial pattern, as all items fit, _var_lambda[i] is the pattern {i}
+      if( items.size() == 1 )
+      {
+         heurVars.push_back(_var_lambda[items[0]]);
+         continue;
+      }
+
+      SCIP_VAR* var;
+
+      SCIPsnprintf(var_name, 255, "pattern_heur_%d", j);
+
+      SCIPcreateObjVar(_scipPM,
+                       &var,
+                       var_name,                  // name
+                       0,                         // lower bound
+                       1,                         // upper bound
+                       1,                         // objective function coefficient: every used bin costs 1
+                       SCIP_VARTYPE_BINARY,       // variable type
+                       TRUE,                      // initial
+                       FALSE,                     // removable
+                       new PatternVardata(items), // variable data: the items of the pattern
+                       TRUE);                     // delete the variable data together with the variable
+
+      SCIPchgVarUbLazy(_scipPM, var, 1.0);
+      SCIPaddVar(_scipPM, var);
+      for( int i : items )
+      {
+         SCIPaddCoefLinear(_scipPM, _cons_item_covering[i], var, 1);
+      }
+
+      _var_lambda.push_back(var);
+      heurVars.push_back(var);
+   }
+
+   SCIP_Bool stored;
+
+   SCIPcreateSol(_scipPM, &_sol, NULL);
+   for( SCIP_VAR* var : heurVars )
+   {
+      SCIPsetSolVal(_scipPM, _sol, var, 1);
+   }
+   SCIPaddSol(_scipPM, _sol, &stored);
+   SCIPfreeSol(_scipPM, &_sol);
+};
+
+/**
+ * @brief solve the pattern model
+ *
+ * @note This function solves the pattern model using SCIPsolve. It prints a message to the console indicating that it
+ * is starting to solve the pattern model. The message is printed by the message handler of SCIP, so it is suppressed
+ * together with the SCIP output, if the message handler is set quiet.
+ */
+void PatternModel::solve()
+{
+   SCIPinfoMessage(_scipPM,
+                   NULL,
+                   "___________________________________________________________________________________________\n");
+   SCIPinfoMessage(_scipPM, NULL, "start Solving pattern Model: \n");
+   SCIPsolve(_scipPM);
+};
+
+/**
+ * @brief Display the used patterns of the best solution
+ *
+ * @note Most pattern variables are generated during the solving process and have no meaningful name, so instead of
+ * the variable values the items of every used pattern are printed, one bin per line. As the item constraints are
+ * covering constraints, an item may be contained in more than one used pattern; it is then only printed once.
+ */
+void PatternModel::displaySolution()
+{
+   _sol = SCIPgetBestSol(_scipPM);
+   if( _sol == NULL )
+   {
+      cout << "no solution found\n";
+      return;
+   }
+
+   SCIP_VAR**   vars  = SCIPgetVars(_scipPM);
+   int          nvars = SCIPgetNVars(_scipPM);
+   int          bin   = 0;
+   vector<bool> packed(_ins->_nbItems, false); // an item covered twice is only printed in its first bin
+
+   cout << "objective value: " << SCIPgetSolOrigObj(_scipPM, _sol) << "\n";
+
+   for( int v = 0; v < nvars; ++v )
+   {
+      if( SCIPgetSolVal(_scipPM, _sol, vars[v]) < 0.5 )
+         continue;
+
+      PatternVardata* vardata = dynamic_cast<PatternVardata*>(SCIPgetObjVardata(_scipPM, vars[v]));
+
+      cout << "bin " << bin++ << ":";
+      for( int i : vardata->_items )
+      {
+         if( !packed[i] )
+            cout << " " << i;
+         packed[i] = true;
+      }
+      cout << "\n";
+   }
+};
@@ -0,0 +1,73 @@
+// PatternModel.h
+#pragma once
+
+#include "Heuristic.h"
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+#include "objscip/objscipdefplugins.h"
+
+using namespace scip;
+
+/**
+ * @brief The pattern formulation of Gilmore and Gomory for the BPP, solved by branch-and-price
+ *
+ * @param _scipPM pointer to the scip environment for the pattern model
+ *
+ * @param _sol pointer to the solution of the pattern model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _var pointer to various SCIP-variables
+ *
+ * @param _cons pointer to various SCIP-constraints
+ *
+ * @note PatternModel is a class that implements the pattern formulation for the Bin Packing Problem (BPP). Every
+ * variable lambda_p represents a pattern p, a feasible filling of a single bin, and is equal to 1, if the pattern is
+ * used. The only constraints are the item covering constraints (every item i \in I is contained in at least one used
+ * pattern). As there are exponentially many patterns, the model starts with one pattern per item and generates further
+ * patterns by column generation (see PricerKnapsack). Integrality is enforced by the Ryan-Foster branching on item
+ * pairs (see BranchRyanFoster, ConsSameDiff). The LP relaxation is much stronger and free of the bin symmetry of the
+ * compact model. The class has the same interface as CompactModel and takes the same Instance pointer.
+ */
+class PatternModel
+{
+
+public:
+   // constructor
+   PatternModel(Instance* ins);
+
+   // destructor
+   ~PatternModel();
+
+   // solve the problem
+   void solve();
+
+   // display the solution
+   void displaySolution();
+
+   // set all optional SCIP-Parameters
+   void setSCIPParameters();
+
+   // add the bins of the heuristic as patterns and pass the packing to SCIP as a starting solution
+   void addStartSolution(Heuristic* heur);
+
+   // returns the scip environment, e.g. to change parameters or to read the statistics after solving
+   SCIP* getSCIP() { return _scipPM; }
+
+private:
+   SCIP*     _scipPM; // pointer to the scip environment for the pattern model
+   SCIP_SOL* _sol;    // pointer to the solution of the pattern model
+
+   Instance* _ins; // pointer to the instance
+
+   // variables
+   vector<SCIP_VAR*> _var_lambda; // lambda_p: =1, if pattern p is used, only the initial patterns are stored here, the
+                                  // priced patterns are owned by SCIP
+
+   // constraints
+   vector<SCIP_CONS*> _cons_item_covering; // item covering constraint: every item i is contained in at least one used
+                                           // pattern
+                                           // dimension: number of items
+};
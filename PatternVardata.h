@@ -0,0 +1,33 @@
+// PatternVardata.h
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace std;
+using namespace scip;
+
+/**
+ * @brief variable data of a pattern variable lambda_p in the pattern model
+ *
+ * @param _items sorted indices of all items i \in I, which are packed into the pattern p
+ *
+ * @note Every column of the Gilmore-Gomory pattern formulation represents a feasible filling of a single bin. SCIP
+ * stores this object together with the variable, so the pricer, the Ryan-Foster branching rule and the same/differ
+ * constraint handler can find out which items are covered by a (possibly priced) variable. The default transformation
+ * of scip::ObjVardata uses the same object for the original and the transformed variable.
+ */
+class PatternVardata : public ObjVardata
+{
+public:
+   // constructor, the items are stored sorted to allow binary searches
+   PatternVardata(const vector<int>& items) : _items(items) { sort(_items.begin(), _items.end()); }
+
+   // returns true, if item i is packed into this pattern
+   bool contains(int i) const { return binary_search(_items.begin(), _items.end(), i); }
+
+   vector<int> _items; // items i \in I, which are packed into this pattern
+};
@@ -0,0 +1,348 @@
+// Portfolio.cpp
+#include "Portfolio.h"
+#include "CompactModel.h"
+
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <thread>
+
+// #####################################################################################################################
+//  plugins, which connect a model to the portfolio
+// #####################################################################################################################
+
+// events of the portfolio
+#define PORTFOLIO_EVENTS (SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED)
+
+/**
+ * @brief event handler, which publishes the incumbents of a model and interrupts its solve, when the portfolio is solved
+ *
+ * @note A dual bound, which reaches the shared incumbent, proves its optimality (the number of bins is integral).
+ */
+class EventPortfolio : public ObjEventhdlr
+{
+public:
+   EventPortfolio(SCIP* scip, Portfolio* portfolio, CompactModel* model, int c)
+       : ObjEventhdlr(scip, "portfolio", "publishes the incumbents and interrupts the solve of a portfolio")
+   {
+      _portfolio = portfolio;
+      _model     = model;
+      _c         = c;
+   }
+
+   virtual ~EventPortfolio() {}
+
+   virtual SCIP_DECL_EVENTINITSOL(scip_initsol)
+   {
+      SCIP_CALL(SCIPcatchEvent(scip, PORTFOLIO_EVENTS, eventhdlr, NULL, NULL));
+      return SCIP_OKAY;
+   }
+
+   virtual SCIP_DECL_EVENTEXITSOL(scip_exitsol)
+   {
+      SCIP_CALL(SCIPdropEvent(scip, PORTFOLIO_EVENTS, eventhdlr, NULL, -1));
+      return SCIP_OKAY;
+   }
+
+   virtual SCIP_DECL_EVENTEXEC(scip_exec)
+   {
+      if( SCIPeventGetType(event) & SCIP_EVENTTYPE_BESTSOLFOUND )
+      {
+         vector<int> packing = _model->getPacking();
+         if( !packing.empty() )
+            _portfolio->publish(packing, (int) lround(SCIPgetPrimalbound(scip)));
+      }
+
+      if( !_portfolio->_solved && _portfolio->_bestBins <= ceil(SCIPgetDualbound(scip) - 1e-6) )
+         _portfolio->finish(_c);
+
+      if( _portfolio->_solved )
+         SCIP_CALL(SCIPinterruptSolve(scip));
+
+      return SCIP_OKAY;
+   }
+
+private:
+   Portfolio*    _portfolio; // pointer to the portfolio
+   CompactModel* _model;     // pointer to the model of the configuration
+   int           _c;         // index of the configuration
+};
+
+/**
+ * @brief primal heuristic, which passes the shared incumbent to a model, if it is better than the own incumbent
+ */
+class HeurPortfolio : public ObjHeur
+{
+public:
+   HeurPortfolio(SCIP* scip, Portfolio* portfolio, CompactModel* model)
+       : ObjHeur(scip,
+                 "portfolio",                                    // name
+                 "passes the shared incumbent of the portfolio", // description
+                 'P',                                            // display character
+                 1000000,                                        // priority
+                 1,                                              // frequency
+                 0,                                              // frequency offset
+                 -1,                                             // maximal depth
+                 SCIP_HEURTIMING_BEFORENODE,                     // timing
+                 FALSE)                                          // uses a sub-SCIP
+   {
+      _portfolio = portfolio;
+      _model     = model;
+   }
+
+   virtual ~HeurPortfolio() {}
+
+   virtual SCIP_DECL_HEUREXEC(scip_exec)
+   {
+      *result = SCIP_DIDNOTRUN;
+
+      if( _portfolio->_bestBins >= SCIPgetPrimalbound(scip) - 0.5 )
+         return SCIP_OKAY;
+
+      *result = _model->tryPacking(_portfolio->bestPacking(), heur) ? SCIP_FOUNDSOL : SCIP_DIDNOTFIND;
+
+      return SCIP_OKAY;
+   }
+
+private:
+   Portfolio*    _portfolio; // pointer to the portfolio
+   CompactModel* _model;     // pointer to the model of the configuration
+};
+
+// #####################################################################################################################
+//  portfolio
+// #####################################################################################################################
+
+/**
+ * @brief Construct a new Portfolio:: Portfolio object
+ *
+ * @param ins pointer to the instance
+ *
+ * @param settings settings of the solve
+ *
+ * @param nbConfigurations number of configurations, <= 0: one per core
+ *
+ * @note Configuration k uses symmetry breaking for odd k, the emphasis default, optimality, feasibility and easy CIP
+ * cycles with every second configuration, and the random seed is shifted by k / 8, so the first eight configurations
+ * differ in formulation and emphasis only.
+ */
+Portfolio::Portfolio(Instance* ins, const SolverSettings& settings, int nbConfigurations)
+{
+   _ins      = ins;
+   _settings = settings;
+   _bestBins = INT_MAX;
+   _solved   = false;
+   _winner   = -1;
+   _status   = "unknown";
+   _bound    = 0;
+
+   if( nbConfigurations <= 0 )
+      nbConfigurations = max(1, (int) thread::hardware_concurrency());
+
+   const SCIP_PARAMEMPHASIS emphasis[4]     = {SCIP_PARAMEMPHASIS_DEFAULT,
+                                               SCIP_PARAMEMPHASIS_OPTIMALITY,
+                                               SCIP_PARAMEMPHASIS_FEASIBILITY,
+                                               SCIP_PARAMEMPHASIS_EASYCIP};
+   const char*              emphasisName[4] = {"default", "optimality", "feasibility", "easycip"};
+
+   for( int k = 0; k < nbConfigurations; ++k )
+   {
+      PortfolioConfiguration configuration;
+      configuration._symmetryBreaking = k % 2 == 1;
+      configuration._emphasis         = emphasis[(k / 2) % 4];
+      configuration._seed             = k / 8;
+      configuration._name             = string(configuration._symmetryBreaking ? "sym_" : "nosym_")
+                                      + emphasisName[(k / 2) % 4] + "_" + to_string(configuration._seed);
+      _configurations.push_back(configuration);
+   }
+}
+
+/**
+ * @brief publish a packing as shared incumbent
+ *
+ * @param bin_of_item bin of every item
+ *
+ * @param nbBins number of bins of the packing
+ */
+bool Portfolio::publish(const vector<int>& bin_of_item, int nbBins)
+{
+   lock_guard<mutex> lock(_mutex);
+
+   if( nbBins >= _bestBins )
+      return false;
+
+   _bestBins    = nbBins;
+   _bestPacking = bin_of_item;
+   return true;
+}
+
+/**
+ * @brief the shared incumbent, empty if there is none
+ */
+vector<int> Portfolio::bestPacking()
+{
+   lock_guard<mutex> lock(_mutex);
+   return _bestPacking;
+}
+
+/**
+ * @brief mark the portfolio as solved, only the first call sets the winner
+ */
+void Portfolio::finish(int c)
+{
+   lock_guard<mutex> lock(_mutex);
+
+   if( _solved )
+      return;
+
+   _winner = c;
+   _solved = true;
+}
+
+/**
+ * @brief solve configuration c
+ *
+ * @note A configuration, which starts after the portfolio is solved, is not solved at all (status "interrupted").
+ */
+void Portfolio::solve(int c, Heuristic* heur)
+{
+   auto start = chrono::steady_clock::now();
+
+   const PortfolioConfiguration& configuration = _configurations[c];
+   SolveResult&                  result        = _results[c];
+   result._instance                            = configuration._name;
+   result._model                               = configuration._symmetryBreaking ? "compact_sym" : "compact";
+   result._status                              = "interrupted";
+
+   if( _solved )
+      return;
+
+   CompactModel* model = new CompactModel(_ins, configuration._symmetryBreaking, _settings._production);
+   if( _settings._binPacking )
+      model->addBinPackingConstraint();
+   if( _settings._roundingFreq >= 0 )
+      model->addRoundingHeuristic(_settings._roundingFreq);
+   if( _settings._cutsFreq >= 0 )
+      model->addSeparator(_settings._cutsFreq);
+   model->addStartSolution(heur);
+
+   // the emphasis may change the parameters, which the constructor of the model has set, so they are set again
+   SCIP* scip = model->getSCIP();
+   if( configuration._emphasis != SCIP_PARAMEMPHASIS_DEFAULT )
+   {
+      SCIPsetEmphasis(scip, configuration._emphasis, TRUE);
+      model->setSCIPParameters();
+   }
+   SCIPsetIntParam(scip, "randomization/randomseedshift", configuration._seed);
+   SCIPsetRealParam(scip, "limits/time", _settings._timeLimit);
+   SCIPsetMessagehdlrQuiet(scip, TRUE);
+
+   SCIPincludeObjEventhdlr(scip, new EventPortfolio(scip, this, model, c), TRUE);
+   SCIPincludeObjHeur(scip, new HeurPortfolio(scip, this, model), TRUE);
+   result._buildTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   if( !_solved )
+   {
+      model->solve();
+      readSCIPResult(scip, result);
+
+      if( result._status == "optimal" )
+      {
+         vector<int> packing = model->getPacking();
+         if( !packing.empty() )
+            publish(packing, (int) lround(result._bins));
+         finish(c);
+      }
+      else if( result._status == "infeasible" )
+         finish(c);
+   }
+
+   delete model;
+
+   result._time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief race all configurations
+ *
+ * @param heur heuristic, which has already been run, its packing is the first shared incumbent and the starting
+ * solution of every model
+ *
+ * @note The function returns, when every configuration has finished or interrupted itself. The portfolio is optimal,
+ * if a configuration has proven optimality or the best dual bound reaches the shared incumbent. Otherwise the status
+ * is "infeasible", if a configuration has proven infeasibility, and the status of the first configuration else.
+ */
+void Portfolio::run(Heuristic* heur)
+{
+   _bestBins    = heur->_feasible ? heur->_nbBinsUsed : INT_MAX;
+   _bestPacking = heur->_feasible ? heur->_bin_of_item : vector<int>();
+   _solved      = false;
+   _winner      = -1;
+   _results.assign(_configurations.size(), SolveResult());
+
+   vector<thread> threads;
+   for( size_t c = 0; c < _configurations.size(); ++c )
+   {
+      threads.emplace_back(&Portfolio::solve, this, (int) c, heur);
+   }
+   for( thread& t : threads )
+   {
+      t.join();
+   }
+
+   _bound = 0;
+   for( const SolveResult& result : _results )
+   {
+      if( result._status != "interrupted" || result._bound > 0 )
+         _bound = max(_bound, result._bound);
+   }
+
+   bool infeasible = false;
+   for( const SolveResult& result : _results )
+   {
+      infeasible = infeasible || result._status == "infeasible";
+   }
+
+   if( infeasible )
+      _status = "infeasible";
+   else if( _bestBins < INT_MAX && (_solved || ceil(_bound - 1e-6) >= _bestBins) )
+   {
+      _status = "optimal";
+      _bound  = _bestBins;
+   }
+   else
+      _status = _results[0]._status;
+}
+
+/**
+ * @brief display the result of every configuration
+ */
+void Portfolio::display()
+{
+   cout << "Portfolio: " << _configurations.size() << " configurations, status " << _status << ", bins "
+        << (_bestBins < INT_MAX ? to_string(_bestBins) : "-") << ", bound " << _bound << endl;
+
+   for( size_t c = 0; c < _results.size(); ++c )
+   {
+      const SolveResult& result = _results[c];
+      cout << ((int) c == _winner ? "* " : "  ") << result._instance << ": " << result._status << ", bins "
+           << result._bins << ", bound " << result._bound << ", time " << result._time << " s" << endl;
+   }
+}
+
+/**
+ * @brief the results of all configurations as a JSON object
+ */
+string Portfolio::toJSON() const
+{
+   ostringstream json;
+   json << "{\"winner\":\"" << (_winner >= 0 ? _configurations[_winner]._name : "") << "\",\"configurations\":[";
+   for( size_t c = 0; c < _results.size(); ++c )
+   {
+      const SolveResult& result = _results[c];
+      json << (c > 0 ? "," : "") << "{\"name\":\"" << result._instance << "\",\"status\":\"" << result._status
+           << "\",\"bins\":" << result._bins << ",\"bound\":" << result._bound << ",\"time\":" << result._time << "}";
+   }
+   json << "]}";
+   return json.str();
+}
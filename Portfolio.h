@@ -0,0 +1,88 @@
+// Portfolio.h
+#pragma once
+
+#include "Heuristic.h"
+#include "Instance.h"
+#include "Solver.h"
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief configuration of the compact model in the portfolio
+ */
+struct PortfolioConfiguration
+{
+   string             _name;             // name, e.g. "sym_optimality_3"
+   bool               _symmetryBreaking; // symmetry-broken formulation (see CompactModel)
+   SCIP_PARAMEMPHASIS _emphasis;         // emphasis setting of SCIP
+   int                _seed;             // shift of the random seeds of SCIP
+};
+
+/**
+ * @brief races several configurations of the compact model for a single instance on separate threads
+ *
+ * @param _ins pointer to the instance, it is only read
+ *
+ * @param _settings settings of the solve, the plugins of the compact model are used by every configuration
+ *
+ * @param _configurations the configurations, one thread each
+ *
+ * @param _results result of every configuration
+ *
+ * @param _bestBins, _bestPacking shared incumbent of all configurations
+ *
+ * @note Every configuration solves its own compact model in its own SCIP environment. The configurations differ in the
+ * formulation (with or without symmetry breaking), the emphasis setting of SCIP (default, optimality, feasibility,
+ * easy CIP) and the random seed. Two plugins connect every model to the portfolio: an event handler publishes every new
+ * incumbent of the model as shared incumbent, and a primal heuristic passes the shared incumbent to the model, as soon
+ * as it is better than the own one, so it serves as cutoff for all configurations. The portfolio is solved, as soon as
+ * one configuration proves optimality, either by finishing its solve or by a dual bound, which reaches the shared
+ * incumbent. Then every other configuration interrupts itself with SCIPinterruptSolve() at its next event, so SCIP is
+ * only called from the thread, which owns the environment. The bound of the portfolio is the best dual bound of all
+ * configurations.
+ */
+class Portfolio
+{
+public:
+   // constructor, nbConfigurations <= 0: one configuration per core
+   Portfolio(Instance* ins, const SolverSettings& settings, int nbConfigurations);
+
+   // race all configurations, the heuristic packing is the first shared incumbent
+   void run(Heuristic* heur);
+
+   // display the result of every configuration
+   void display();
+
+   // the results of all configurations as a JSON object
+   string toJSON() const;
+
+   // publish a packing of a configuration as shared incumbent, if it needs fewer bins, true if it is published
+   bool publish(const vector<int>& bin_of_item, int nbBins);
+
+   // the shared incumbent
+   vector<int> bestPacking();
+
+   // mark the portfolio as solved by configuration c, the other configurations interrupt themselves
+   void finish(int c);
+
+   vector<PortfolioConfiguration> _configurations; // the configurations
+   vector<SolveResult>            _results;        // result of every configuration
+
+   atomic<int>  _bestBins; // number of bins of the shared incumbent, INT_MAX if there is none
+   atomic<bool> _solved;   // true, if a configuration has proven optimality
+   int          _winner;   // configuration, which has proven optimality, -1 if none
+
+   string _status; // status of the portfolio
+   double _bound;  // best dual bound of all configurations
+
+private:
+   // solve configuration c in the calling thread
+   void solve(int c, Heuristic* heur);
+
+   Instance*      _ins;      // pointer to the instance
+   SolverSettings _settings; // settings of the solve
+
+   mutex       _mutex;       // mutex of the shared incumbent and the winner
+   vector<int> _bestPacking; // bin of every item in the shared incumbent
+};
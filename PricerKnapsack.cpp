@@ -0,0 +1,342 @@
+// PricerKnapsack.cpp
+#include "PricerKnapsack.h"
+#include "ConsSameDiff.h"
+#include "PatternVardata.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief Construct a new PricerKnapsack:: PricerKnapsack object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param ins pointer to the instance
+ *
+ * @param cons_item_covering original item covering constraints of the master problem
+ */
+PricerKnapsack::PricerKnapsack(SCIP* scip, Instance* ins, const vector<SCIP_CONS*>& cons_item_covering)
+    : ObjPricer(scip,
+                "knapsack",                                 // name
+                "pricer solving a 0/1 knapsack problem",    // description
+                0,                                          // priority
+                TRUE)                                       // delay: only call pricer if all problem vars are priced
+{
+   _ins                = ins;
+   _cons_item_covering = cons_item_covering;
+   _nbPricedVars       = 0;
+}
+
+/**
+ * @brief initialization of the pricer: replace the original constraints by the transformed constraints
+ *
+ * @note The pricer works on the transformed problem, so the duals and the coefficients of new variables have to be
+ * taken from and added to the transformed constraints.
+ */
+SCIP_DECL_PRICERINIT(PricerKnapsack::scip_init)
+{
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      SCIP_CALL(SCIPgetTransformedCons(scip, _cons_item_covering[i], &_cons_item_covering[i]));
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief reduced cost pricing
+ */
+SCIP_DECL_PRICERREDCOST(PricerKnapsack::scip_redcost)
+{
+   SCIP_CALL(pricing(scip, false, lowerbound, result));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief Farkas pricing
+ */
+SCIP_DECL_PRICERFARKAS(PricerKnapsack::scip_farkas)
+{
+   SCIP_CALL(pricing(scip, true, NULL, result));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief solve the pricing problem and add a pattern with negative reduced cost, if there is one
+ *
+ * @note The items are first merged according to the active SAME-constraints (union-find), the active
+ * DIFFER-constraints become conflicts between the merged items. Merged items without positive profit or with a weight
+ * larger than the capacity can never improve a pattern and are dropped. As the knapsack problem is solved exactly, the
+ * Farley bound z_LP / z_knapsack is a valid lower bound of the current node and handed to SCIP. For integral instances
+ * the knapsack problem is solved on the integral weights, so the capacity checks are exact.
+ */
+SCIP_RETCODE PricerKnapsack::pricing(SCIP* scip, bool isfarkas, SCIP_Real* lowerbound, SCIP_RESULT* result)
+{
+   *result = SCIP_SUCCESS;
+
+   // #####################################################################################################################
+   //  get the dual values of the item covering constraints
+   // #####################################################################################################################
+
+   vector<double> dual(_ins->_nbItems);
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      dual[i] = isfarkas ? SCIPgetDualfarkasLinear(scip, _cons_item_covering[i])
+                         : SCIPgetDualsolLinear(scip, _cons_item_covering[i]);
+   }
+
+   // #####################################################################################################################
+   //  merge items according to the active branching decisions
+   // #####################################################################################################################
+
+   // union-find over the items, SAME-constraints join two sets
+   vector<int> representative(_ins->_nbItems);
+   iota(representative.begin(), representative.end(), 0);
+
+   auto find = [&representative](int i)
+   {
+      while( representative[i] != i )
+      {
+         representative[i] = representative[representative[i]];
+         i                 = representative[i];
+      }
+      return i;
+   };
+
+   vector<pair<int, int>> differ;
+
+   SCIP_CONSHDLR* conshdlr = SCIPfindConshdlr(scip, "samediff");
+   SCIP_CONS**    conss    = SCIPconshdlrGetConss(conshdlr);
+   int            nconss   = SCIPconshdlrGetNActiveConss(conshdlr); // the active constraints come first
+
+   for( int c = 0; c < nconss; ++c )
+   {
+      SCIP_CONSDATA* consdata = SCIPconsGetData(conss[c]);
+
+      if( consdata->type == SAME )
+         representative[find(consdata->item1)] = find(consdata->item2);
+      else
+         differ.push_back({consdata->item1, consdata->item2});
+   }
+
+   // build one knapsack item per set of merged items
+   vector<int>         group(_ins->_nbItems, -1); // knapsack item of every representative
+   vector<double>      weight;
+   vector<long long>   intWeight; // integral weight of every knapsack item, only for integral instances
+   vector<double>      profit;
+   vector<vector<int>> members;
+
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      int r = find(i);
+      if( group[r] == -1 )
+      {
+         group[r] = (int) weight.size();
+         weight.push_back(0);
+         intWeight.push_back(0);
+         profit.push_back(0);
+         members.push_back({});
+      }
+      weight[group[r]] += _ins->par_w[i];
+      intWeight[group[r]] += _ins->_integral ? _ins->int_w[i] : 0;
+      profit[group[r]] += dual[i];
+      members[group[r]].push_back(i);
+   }
+
+   // drop knapsack items, which never improve a pattern
+   vector<int>       index(weight.size(), -1);
+   vector<double>    reducedWeight;
+   vector<long long> reducedIntWeight;
+   vector<double>    reducedProfit;
+   vector<int>       original; // knapsack item in the unreduced problem
+
+   for( size_t g = 0; g < weight.size(); ++g )
+   {
+      if( SCIPisDualfeasPositive(scip, profit[g]) && SCIPisFeasLE(scip, weight[g], _ins->par_b) )
+      {
+         index[g] = (int) reducedWeight.size();
+         reducedWeight.push_back(weight[g]);
+         reducedIntWeight.push_back(intWeight[g]);
+         reducedProfit.push_back(profit[g]);
+         original.push_back((int) g);
+      }
+   }
+
+   vector<vector<int>> conflicts(reducedWeight.size());
+   for( const auto& d : differ )
+   {
+      int g1 = index[group[find(d.first)]];
+      int g2 = index[group[find(d.second)]];
+
+      if( g1 >= 0 && g2 >= 0 )
+      {
+         conflicts[g1].push_back(g2);
+         conflicts[g2].push_back(g1);
+      }
+   }
+
+   // #####################################################################################################################
+   //  solve the knapsack problem and add the pattern, if it has negative reduced cost
+   // #####################################################################################################################
+
+   vector<int> packed;
+   double      value = _ins->_integral
+                          ? solveKnapsack(reducedIntWeight, reducedProfit, conflicts, _ins->int_b, packed)
+                          : solveKnapsack(reducedWeight, reducedProfit, conflicts, _ins->par_b, packed);
+
+   double redcost = (isfarkas ? 0.0 : 1.0) - value;
+
+   if( SCIPisDualfeasNegative(scip, redcost) )
+   {
+      vector<int> items;
+      for( int g : packed )
+      {
+         const vector<int>& m = members[original[g]];
+         items.insert(items.end(), m.begin(), m.end());
+      }
+
+      SCIP_CALL(addPatternVar(scip, items));
+   }
+
+   // Farley bound: every pattern has cost 1, so no solution of the node uses less than z_LP / z_knapsack bins
+   if( !isfarkas && value > 1.0 )
+   {
+      *lowerbound = SCIPgetLPObjval(scip) / value;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief create a new pattern variable and add it to the item covering constraints of its items
+ */
+SCIP_RETCODE PricerKnapsack::addPatternVar(SCIP* scip, const vector<int>& items)
+{
+   char      var_name[255];
+   SCIP_VAR* var;
+
+   SCIPsnprintf(var_name, 255, "pattern_priced_%d", _nbPricedVars++);
+
+   SCIP_CALL(SCIPcreateObjVar(scip,
+                              &var,
+                              var_name,
+                              0.0,                        // lower bound
+                              1.0,                        // upper bound
+                              1.0,                        // objective function coefficient: every bin costs 1
+                              SCIP_VARTYPE_BINARY,        // variable type
+                              FALSE,                      // initial
+                              TRUE,                       // removable
+                              new PatternVardata(items),  // variable data
+                              TRUE));                     // delete the variable data together with the variable
+
+   // the upper bound 1 is only added as a bound change to the LP, if it is violated
+   SCIP_CALL(SCIPchgVarUbLazy(scip, var, 1.0));
+
+   SCIP_CALL(SCIPaddPricedVar(scip, var, 1.0));
+
+   for( int i : items )
+   {
+      SCIP_CALL(SCIPaddCoefLinear(scip, _cons_item_covering[i], var, 1.0));
+   }
+
+   SCIP_CALL(SCIPreleaseVar(scip, &var));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief state of the depth-first branch-and-bound for the knapsack problem, W is the type of the weights
+ */
+template <typename W>
+struct KnapsackSearch
+{
+   const vector<W>&           weight;
+   const vector<double>&      profit;
+   const vector<vector<int>>& conflicts;
+   vector<int>                order;   // knapsack items sorted by decreasing profit / weight ratio
+   vector<int>                blocked; // number of packed items in conflict with every knapsack item
+   vector<int>                current; // currently packed knapsack items
+   vector<int>                best;    // best packing found so far
+   double                     bestValue;
+
+   // Dantzig bound: fill the remaining capacity fractionally with the remaining, not blocked items
+   double bound(size_t k, W capacity, double value) const
+   {
+      for( ; k < order.size(); ++k )
+      {
+         int j = order[k];
+         if( blocked[j] > 0 )
+            continue;
+         if( weight[j] > capacity )
+            return value + profit[j] * (double) capacity / (double) weight[j];
+         capacity -= weight[j];
+         value += profit[j];
+      }
+      return value;
+   }
+
+   // branch on the k-th item of the order: first pack it, then leave it out
+   void search(size_t k, W capacity, double value)
+   {
+      if( value > bestValue )
+      {
+         bestValue = value;
+         best      = current;
+      }
+
+      if( k == order.size() || bound(k, capacity, value) <= bestValue + 1e-9 )
+         return;
+
+      int j = order[k];
+      if( blocked[j] == 0 && fits(W(0), weight[j], capacity) )
+      {
+         for( int c : conflicts[j] )
+            ++blocked[c];
+         current.push_back(j);
+
+         search(k + 1, capacity - weight[j], value + profit[j]);
+
+         current.pop_back();
+         for( int c : conflicts[j] )
+            --blocked[c];
+      }
+
+      search(k + 1, capacity, value);
+   }
+};
+
+/**
+ * @brief solve a 0/1 knapsack problem with conflicts exactly by depth-first branch-and-bound
+ *
+ * @note The items are sorted by decreasing profit / weight ratio, so the first dive is the greedy solution and the
+ * Dantzig bound of the remaining items is computed by a single scan. Items in conflict with a packed item are skipped
+ * in the bound as well, which keeps the bound valid for the whole subtree.
+ */
+template <typename W>
+double solveKnapsack(const vector<W>&           weight,
+                     const vector<double>&      profit,
+                     const vector<vector<int>>& conflicts,
+                     W                          capacity,
+                     vector<int>&               packed)
+{
+   KnapsackSearch<W> ks{weight, profit, conflicts, {}, vector<int>(weight.size(), 0), {}, {}, 0.0};
+
+   ks.order.resize(weight.size());
+   iota(ks.order.begin(), ks.order.end(), 0);
+   sort(ks.order.begin(),
+        ks.order.end(),
+        [&](int a, int b) { return profit[a] * (double) weight[b] > profit[b] * (double) weight[a]; });
+
+   ks.search(0, capacity, 0.0);
+
+   packed = ks.best;
+   return ks.bestValue;
+}
+
+template double solveKnapsack<double>(const vector<double>&, const vector<double>&, const vector<vector<int>>&, double,
+                                      vector<int>&);
+template double solveKnapsack<long long>(const vector<long long>&, const vector<double>&, const vector<vector<int>>&,
+                                         long long, vector<int>&);
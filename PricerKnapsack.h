@@ -0,0 +1,78 @@
+// PricerKnapsack.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief pricer for the pattern model, which solves the pricing problem as a 0/1 knapsack problem
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _cons_item_covering (transformed) item covering constraints of the master problem
+ *
+ * @param _nbPricedVars number of variables generated by this pricer, used for the names of the variables
+ *
+ * @note Given the duals pi_i of the item covering constraints, a pattern p has the reduced cost 1 - sum(i in p, pi_i).
+ * A pattern with negative reduced cost exists, iff the 0/1 knapsack problem max sum(i, pi_i * a_i) s.t.
+ * sum(i, w_i * a_i) <= b has an optimal value greater than 1. The knapsack problem is solved exactly by a depth-first
+ * branch-and-bound, which is bounded by the Dantzig bound of the remaining items. The active branching decisions of the
+ * Ryan-Foster branching are respected: items, which must be packed together, are merged into a single knapsack item,
+ * items, which must be packed into different bins, are in conflict. If the master LP is infeasible (e.g. after a
+ * SAME-branching forbids all existing patterns of an item), the Farkas multipliers are used as profits instead.
+ */
+class PricerKnapsack : public ObjPricer
+{
+public:
+   // constructor
+   PricerKnapsack(SCIP* scip, Instance* ins, const vector<SCIP_CONS*>& cons_item_covering);
+
+   // destructor
+   virtual ~PricerKnapsack() {}
+
+   // initialization: get the transformed constraints
+   virtual SCIP_DECL_PRICERINIT(scip_init);
+
+   // reduced cost pricing for a feasible master LP
+   virtual SCIP_DECL_PRICERREDCOST(scip_redcost);
+
+   // Farkas pricing for an infeasible master LP
+   virtual SCIP_DECL_PRICERFARKAS(scip_farkas);
+
+private:
+   // common part of reduced cost and Farkas pricing
+   SCIP_RETCODE pricing(SCIP* scip, bool isfarkas, SCIP_Real* lowerbound, SCIP_RESULT* result);
+
+   // add a new pattern variable for the given items to the master problem
+   SCIP_RETCODE addPatternVar(SCIP* scip, const vector<int>& items);
+
+   Instance*          _ins;                // pointer to the instance
+   vector<SCIP_CONS*> _cons_item_covering; // item covering constraints, dimension: number of items
+   int                _nbPricedVars;       // number of priced variables
+};
+
+/**
+ * @brief solve a 0/1 knapsack problem with conflicts exactly by depth-first branch-and-bound
+ *
+ * @param weight weight of every knapsack item, W is double or long long (exact capacity checks)
+ *
+ * @param profit profit of every knapsack item
+ *
+ * @param conflicts for every knapsack item the list of knapsack items, which must not be packed together with it
+ *
+ * @param capacity capacity of the knapsack
+ *
+ * @param packed returns the indices of the packed knapsack items
+ *
+ * @return the optimal profit
+ */
+template <typename W>
+double solveKnapsack(const vector<W>&           weight,
+                     const vector<double>&      profit,
+                     const vector<vector<int>>& conflicts,
+                     W                          capacity,
+                     vector<int>&               packed);
@@ -0,0 +1,269 @@
+// Reduction.cpp
+#include "Reduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <set>
+
+/**
+ * @brief Construct a new Reduction:: Reduction object
+ *
+ * @param ins pointer to problem-instance
+ */
+Reduction::Reduction(Instance* ins)
+{
+   _ins         = ins;
+   _residual    = nullptr;
+   _scale       = 1;
+   _nbAlone     = 0;
+   _nbExact     = 0;
+   _nbDominated = 0;
+   _dpBudget    = 200000000;
+}
+
+/**
+ * @brief Destroy the Reduction:: Reduction object
+ */
+Reduction::~Reduction() { delete _residual; }
+
+/**
+ * @brief maximal weight of a subset of the items, which is at most the capacity
+ *
+ * @return the maximal weight, -1 if the budget of the bitsets is exhausted
+ *
+ * @note Bit s of the bitset is set, if a subset has the weight s. Every item shifts the bitset by its weight.
+ */
+long long Reduction::maxSubsetSum(const vector<long long>& weights, long long capacity)
+{
+   long long nbWords = capacity / 64 + 1;
+   if( (long long) weights.size() * nbWords > _dpBudget )
+      return -1;
+   _dpBudget -= (long long) weights.size() * nbWords;
+
+   vector<uint64_t> reachable(nbWords, 0);
+   reachable[0] = 1;
+
+   for( long long w : weights )
+   {
+      long long shiftWords = w / 64;
+      int       shiftBits  = (int) (w % 64);
+
+      for( long long k = nbWords - 1; k >= shiftWords; --k )
+      {
+         uint64_t bits = reachable[k - shiftWords] << shiftBits;
+         if( shiftBits > 0 && k - shiftWords - 1 >= 0 )
+            bits |= reachable[k - shiftWords - 1] >> (64 - shiftBits);
+         reachable[k] |= bits;
+      }
+   }
+
+   for( long long s = capacity; s >= 0; --s )
+   {
+      if( reachable[s / 64] >> (s % 64) & 1 )
+         return s;
+   }
+   return 0;
+}
+
+/**
+ * @brief reduce the instance
+ *
+ * @return the residual instance
+ *
+ * @note The items, which are not fixed yet, are kept in a set ordered by weight, so the largest item fitting together
+ * with item i and the two smallest items are found in logarithmic time. Item i is taken out of the set, while its
+ * bin is checked, and put back, if no bin is fixed, as it may still be part of a bin of a smaller item. Items heavier
+ * than the capacity are left in the residual instance, so the models report the infeasibility. Items of weight 0 are not
+ * reduced: they would be counted in the dominance checks as part of a set together with item j, and an item of weight
+ * 0 left alone would fix a bin of its own. They are added to the first fixed bin or, if there is none, left in the
+ * residual instance.
+ */
+Instance* Reduction::run()
+{
+   const double tol = 1e-9;
+   double       b   = _ins->par_b;
+
+   bool integral = _ins->_integral;
+
+   set<pair<double, int>> free;
+   vector<int>            empty; // items of weight 0
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( _ins->par_w[i] > 0 )
+         free.insert({_ins->par_w[i], i});
+      else
+         empty.push_back(i);
+   }
+
+   vector<int> order(_ins->_nbItems);
+   iota(order.begin(), order.end(), 0);
+   stable_sort(order.begin(), order.end(), [this](int a, int c) { return _ins->par_w[a] > _ins->par_w[c]; });
+
+   for( int i : order )
+   {
+      if( free.count({_ins->par_w[i], i}) == 0 )
+         continue; // already fixed as the second item of a bin or of weight 0
+
+      double residual = b - _ins->par_w[i];
+      if( residual < -tol )
+         continue; // item does not fit into a bin
+
+      free.erase({_ins->par_w[i], i});
+
+      // largest item, which fits together with item i
+      auto largest = free.upper_bound({residual + tol, _ins->_nbItems});
+      if( largest == free.begin() )
+      {
+         _fixedBins.push_back({i});
+         ++_nbAlone;
+         continue;
+      }
+      --largest;
+      int j = largest->second;
+
+      bool fix = false;
+      if( _ins->par_w[j] >= residual - tol )
+      {
+         fix = true; // item j fills the bin exactly
+         ++_nbExact;
+      }
+      else if( free.size() < 2 || free.begin()->first + next(free.begin())->first > residual + tol )
+      {
+         fix = true; // only single items fit together with item i
+         ++_nbDominated;
+      }
+      else if( integral )
+      {
+         // the heaviest set of items, which fits together with item i, is not heavier than item j; more than
+         // capacity / w items of the same weight w never fit together, so every weight is taken at most this often
+         long long         capacity = _ins->int_b - _ins->int_w[i];
+         vector<long long> weights;
+         for( auto it = free.begin(); it != free.end() && it->first <= residual + tol; )
+         {
+            long long w    = _ins->int_w[it->second];
+            auto      larger = free.lower_bound({it->first, _ins->_nbItems}); // first item of a larger weight
+            for( long long copies = 0; it != larger && copies < capacity / w; ++it, ++copies )
+            {
+               weights.push_back(w);
+            }
+            it = larger;
+         }
+         if( maxSubsetSum(weights, capacity) == _ins->int_w[j] )
+         {
+            fix = true;
+            ++_nbDominated;
+         }
+      }
+
+      if( fix )
+      {
+         _fixedBins.push_back({i, j});
+         free.erase(largest);
+      }
+      else
+      {
+         free.insert({_ins->par_w[i], i});
+      }
+   }
+
+   if( !_fixedBins.empty() )
+   {
+      _fixedBins[0].insert(_fixedBins[0].end(), empty.begin(), empty.end());
+      empty.clear();
+   }
+
+   // residual instance: all items, which are not in a fixed bin, in their original order
+   _item.clear();
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( free.count({_ins->par_w[i], i}) > 0 || _ins->par_w[i] > b + tol || (_ins->par_w[i] <= 0 && !empty.empty()) )
+         _item.push_back(i);
+   }
+
+   delete _residual;
+   _residual           = new Instance();
+   _residual->_nbItems = (int) _item.size();
+   _residual->_nbBins  = (int) _item.size();
+   _residual->par_b    = b;
+   for( int i : _item )
+   {
+      _residual->par_w.push_back(_ins->par_w[i]);
+   }
+
+   // scale the weights and the capacity by the greatest common divisor
+   _scale = 1;
+   if( integral )
+   {
+      long long divisor = 0;
+      for( int i : _item )
+      {
+         divisor = gcd(divisor, _ins->int_w[i]);
+      }
+
+      if( divisor > 1 )
+      {
+         _scale           = (double) divisor;
+         _residual->par_b = floor(b / _scale);
+         for( double& w : _residual->par_w )
+         {
+            w /= _scale;
+         }
+      }
+   }
+   _residual->setIntegral();
+
+   return _residual;
+}
+
+/**
+ * @brief map the packing of the residual instance to a packing of the full instance
+ *
+ * @param residual_bin_of_item bin of every item of the residual instance
+ *
+ * @return bin of every item of the full instance: the fixed bins are 0, ..., nbFixedBins() - 1, the bin j of the
+ * residual packing is nbFixedBins() + j
+ */
+vector<int> Reduction::expand(const vector<int>& residual_bin_of_item) const
+{
+   vector<int> bin_of_item(_ins->_nbItems, -1);
+
+   for( size_t f = 0; f < _fixedBins.size(); ++f )
+   {
+      for( int i : _fixedBins[f] )
+      {
+         bin_of_item[i] = (int) f;
+      }
+   }
+
+   for( size_t k = 0; k < _item.size(); ++k )
+   {
+      bin_of_item[_item[k]] = residual_bin_of_item[k] + nbFixedBins();
+   }
+
+   return bin_of_item;
+}
+
+/**
+ * @brief display the result of the reduction
+ */
+void Reduction::display()
+{
+   cout << "Reduction: " << nbFixedBins() << " fixed bins (" << _nbAlone << " items alone, " << _nbExact
+        << " exact pairs, " << _nbDominated << " dominating pairs), " << _item.size() << " of " << _ins->_nbItems
+        << " items left";
+   if( _scale > 1 )
+      cout << ", weights and capacity divided by " << _scale;
+   cout << endl;
+
+   for( int f = 0; f < nbFixedBins(); ++f )
+   {
+      cout << "fixed bin " << f << ":";
+      for( int i : _fixedBins[f] )
+      {
+         cout << " " << i;
+      }
+      cout << endl;
+   }
+}
@@ -0,0 +1,67 @@
+// Reduction.h
+#pragma once
+
+#include "Instance.h"
+
+/**
+ * @brief reduction of an instance before a model is built
+ *
+ * @param _ins pointer to the full instance
+ *
+ * @param _residual residual instance, which contains the items of no fixed bin
+ *
+ * @param _item item of the full instance for every item of the residual instance
+ *
+ * @param _fixedBins items of the full instance for every bin fixed by the reduction
+ *
+ * @param _scale the weights and the capacity of the residual instance are divided by _scale
+ *
+ * @note The items are processed by decreasing weight. A bin {i} or {i, j} is fixed, if it dominates every other bin
+ * containing item i in the sense of Martello and Toth, so there is an optimal packing, which contains this bin:
+ * - no other item fits together with item i (an item larger than b/2 that nothing can join),
+ * - item j fills the residual capacity b - w_i of item i exactly,
+ * - j is the largest item, which fits together with i, and no set of at least two items fits together with i, or,
+ *   for integral weights, no such set is heavier than j (the reduction procedure MTRP restricted to bins of two
+ *   items, the maximal weight of a set is computed by a subset-sum bitset).
+ * The residual instance contains all other items. If the capacity and all weights are integral, they are divided by
+ * their greatest common divisor (the capacity is rounded down), which does not change the feasible packings. The
+ * number of bins of the residual instance _nbBins is its number of items. expand() maps a packing of the residual
+ * instance back to a packing of the full instance, the fixed bins are the first bins of the full packing.
+ */
+class Reduction
+{
+public:
+   // constructor
+   Reduction(Instance* ins);
+
+   // destructor, frees the residual instance
+   ~Reduction();
+
+   // reduce the instance and return the residual instance, which is owned by the reduction
+   Instance* run();
+
+   // map the packing of the residual instance to a packing of the full instance
+   vector<int> expand(const vector<int>& residual_bin_of_item) const;
+
+   // number of bins fixed by the reduction
+   int nbFixedBins() const { return (int) _fixedBins.size(); }
+
+   // display the result of the reduction
+   void display();
+
+   Instance*           _residual;  // residual instance
+   vector<int>         _item;      // item of the full instance for every item of the residual instance
+   vector<vector<int>> _fixedBins; // items of the full instance in every fixed bin
+   double              _scale;     // divisor of the weights and the capacity of the residual instance
+
+private:
+   // maximal weight of a subset of the items, which is at most the capacity
+   long long maxSubsetSum(const vector<long long>& weights, long long capacity);
+
+   Instance* _ins; // pointer to the full instance
+
+   int       _nbAlone;     // number of items packed alone
+   int       _nbExact;     // number of pairs, which fill a bin exactly
+   int       _nbDominated; // number of pairs fixed by the dominance of the largest fitting item
+   long long _dpBudget;    // remaining number of word operations of the subset-sum bitsets
+};
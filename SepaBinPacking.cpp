@@ -0,0 +1,455 @@
+// SepaBinPacking.cpp
+#include "SepaBinPacking.h"
+#include "LowerBound.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+/**
+ * @brief Construct a new SepaBinPacking:: SepaBinPacking object
+ *
+ * @param scip pointer to the scip environment
+ *
+ * @param ins pointer to the instance
+ *
+ * @param var_X, var_X_begin, var_Y variables of the compact model, the vectors are owned by the model and may grow
+ * between two solves (CompactModel::addItem(), CompactModel::addBin())
+ *
+ * @param freq frequency of the calls (depth in the tree), 0: only at the root node
+ */
+SepaBinPacking::SepaBinPacking(SCIP*                    scip,
+                               Instance*                ins,
+                               const vector<SCIP_VAR*>& var_X,
+                               const vector<int>&       var_X_begin,
+                               const vector<SCIP_VAR*>& var_Y,
+                               int                      freq)
+    : ObjSepa(scip,
+              "binpacking",                                           // name
+              "linking, lifted cover and dual feasible function cuts", // description
+              1000,                                                   // priority
+              freq,                                                   // frequency
+              1.0,                                                    // maximal relative distance to the best node
+              FALSE,                                                  // uses a sub-SCIP
+              FALSE),                                                 // delay
+      _var_X(var_X),
+      _var_X_begin(var_X_begin),
+      _var_Y(var_Y)
+{
+   _ins           = ins;
+   _nbLinkingCuts = 0;
+   _nbCoverCuts   = 0;
+   _nbDFFCuts     = 0;
+   _nbBoundCuts   = 0;
+   _bound         = 0;
+   _boundAdded    = false;
+   _maxThresholds = 20;
+   _maxK          = 10;
+}
+
+/**
+ * @brief start of a solve: store the transformed variables and compute the bound of the bound cut
+ *
+ * @note The model may have been changed since the last solve, so the variables and the bound are set again. Removed
+ * items keep their weight in the instance, but all their variables are fixed to 0 (see CompactModel::removeItem()), so
+ * the bound is computed over the other items only.
+ */
+SCIP_DECL_SEPAINITSOL(SepaBinPacking::scip_initsol)
+{
+   _trans_X.resize(_var_X.size());
+   for( size_t k = 0; k < _var_X.size(); ++k )
+   {
+      SCIP_CALL(SCIPgetTransformedVar(scip, _var_X[k], &_trans_X[k]));
+   }
+
+   _trans_Y.resize(_var_Y.size());
+   for( size_t j = 0; j < _var_Y.size(); ++j )
+   {
+      SCIP_CALL(SCIPgetTransformedVar(scip, _var_Y[j], &_trans_Y[j]));
+   }
+
+   Instance items;
+   items.par_b = _ins->par_b;
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      bool removed = true;
+      for( int k = _var_X_begin[i]; k < _var_X_begin[i + 1] && removed; ++k )
+      {
+         removed = SCIPvarGetUbGlobal(_var_X[k]) < 0.5;
+      }
+      if( !removed )
+         items.par_w.push_back(_ins->par_w[i]);
+   }
+   items._nbItems = (int) items.par_w.size();
+   items._nbBins  = items._nbItems;
+   items.setIntegral();
+
+   LowerBound bound(&items);
+   bound.run();
+   _bound      = bound._best;
+   _boundAdded = false;
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief add the cut sum(k, coef_k X_{item_k j}) <= rhs Y_j
+ *
+ * @param added returns true, if the cut is efficacious and has been added to the LP
+ */
+SCIP_RETCODE SepaBinPacking::addCut(SCIP*                    scip,
+                                    SCIP_SEPA*               sepa,
+                                    int                      j,
+                                    const vector<int>&       item,
+                                    const vector<SCIP_Real>& coef,
+                                    SCIP_Real                rhs,
+                                    SCIP_Bool*               cutoff,
+                                    SCIP_Bool*               added)
+{
+   *added = FALSE;
+
+   SCIP_ROW* row;
+   SCIP_CALL(SCIPcreateEmptyRowSepa(scip, &row, sepa, "", -SCIPinfinity(scip), 0, FALSE, FALSE, TRUE));
+   SCIP_CALL(SCIPcacheRowExtensions(scip, row));
+   for( size_t k = 0; k < item.size(); ++k )
+   {
+      SCIP_CALL(SCIPaddVarToRow(scip, row, _trans_X[_var_X_begin[item[k]] + j], coef[k]));
+   }
+   SCIP_CALL(SCIPaddVarToRow(scip, row, _trans_Y[j], -rhs));
+   SCIP_CALL(SCIPflushRowExtensions(scip, row));
+
+   if( SCIPisCutEfficacious(scip, NULL, row) )
+   {
+      SCIP_CALL(SCIPaddRow(scip, row, FALSE, cutoff));
+      *added = TRUE;
+   }
+
+   SCIP_CALL(SCIPreleaseRow(scip, &row));
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief separate the lifted cover cut of bin j
+ *
+ * @note The cover is built greedily by increasing (Y_j - X_ij) / w_i, until the items do not fit together, and then
+ * made minimal by dropping the items with the largest slack Y_j - X_ij. minWeight[v] is the minimal weight of a subset
+ * of the items in the cut, whose left-hand side is at least v, so the lifting coefficient of item k is the right-hand
+ * side minus the largest v, such that item k fits on top of minWeight[v].
+ */
+template <typename W>
+SCIP_RETCODE SepaBinPacking::separateCover(SCIP*            scip,
+                                           SCIP_SEPA*       sepa,
+                                           int              j,
+                                           const vector<W>& weight,
+                                           W                capacity,
+                                           SCIP_Bool*       cutoff,
+                                           SCIP_Bool*       separated)
+{
+   double y = _valY[j];
+   if( y < 1e-6 )
+      return SCIP_OKAY;
+
+   // candidates: items, which may still be packed into bin j
+   vector<int> candidate;
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( j < _var_X_begin[i + 1] - _var_X_begin[i] && weight[i] > 0
+          && SCIPvarGetUbLocal(_trans_X[_var_X_begin[i] + j]) > 0.5 )
+         candidate.push_back(i);
+   }
+
+   auto x = [&](int i) { return _valX[_var_X_begin[i] + j]; };
+
+   // greedy cover
+   vector<int> order = candidate;
+   stable_sort(order.begin(),
+               order.end(),
+               [&](int a, int b) { return (y - x(a)) / (double) weight[a] < (y - x(b)) / (double) weight[b]; });
+
+   vector<int> cover;
+   W           load    = 0;
+   bool        covered = false;
+   for( int i : order )
+   {
+      cover.push_back(i);
+      if( !fits(load, weight[i], capacity) )
+      {
+         covered = true;
+         break;
+      }
+      load += weight[i];
+   }
+
+   if( !covered )
+      return SCIP_OKAY;
+
+   load += weight[cover.back()];
+
+   // minimal cover
+   stable_sort(cover.begin(), cover.end(), [&](int a, int b) { return y - x(a) > y - x(b); });
+   for( size_t c = 0; c < cover.size() && cover.size() > 1; )
+   {
+      if( !fits(load - weight[cover[c]], (W) 0, capacity) )
+      {
+         load -= weight[cover[c]];
+         cover.erase(cover.begin() + c);
+      }
+      else
+         ++c;
+   }
+
+   int       rhs = (int) cover.size() - 1;
+   vector<W> minWeight(rhs + 1, 0);
+   vector<W> coverWeight;
+   for( int i : cover )
+   {
+      coverWeight.push_back(weight[i]);
+   }
+   sort(coverWeight.begin(), coverWeight.end());
+   for( int v = 1; v <= rhs; ++v )
+   {
+      minWeight[v] = minWeight[v - 1] + coverWeight[v - 1];
+   }
+
+   vector<int>       item = cover;
+   vector<SCIP_Real> coef(cover.size(), 1.0);
+
+   // sequential lifting of the other candidates by decreasing LP value
+   vector<bool> inCover(_ins->_nbItems, false);
+   for( int i : cover )
+   {
+      inCover[i] = true;
+   }
+   stable_sort(candidate.begin(), candidate.end(), [&](int a, int b) { return x(a) > x(b); });
+
+   for( int k : candidate )
+   {
+      if( inCover[k] )
+         continue;
+
+      int alpha = rhs;
+      for( int v = rhs; v >= 0; --v )
+      {
+         if( fits(minWeight[v], weight[k], capacity) )
+         {
+            alpha = rhs - v;
+            break;
+         }
+      }
+
+      if( alpha == 0 )
+         continue;
+
+      item.push_back(k);
+      coef.push_back(alpha);
+      for( int v = rhs; v > 0; --v )
+      {
+         minWeight[v] = min(minWeight[v], minWeight[max(v - alpha, 0)] + weight[k]);
+      }
+   }
+
+   double activity = -rhs * y;
+   for( size_t k = 0; k < item.size(); ++k )
+   {
+      activity += coef[k] * x(item[k]);
+   }
+
+   if( activity > 1e-6 )
+   {
+      SCIP_Bool added;
+      SCIP_CALL(addCut(scip, sepa, j, item, coef, rhs, cutoff, &added));
+      if( added )
+      {
+         ++_nbCoverCuts;
+         *separated = TRUE;
+      }
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief separate the dual feasible function cut of bin j
+ *
+ * @note The thresholds t are 0 and the weights w_i <= b/2 of the LP support of bin j (at most _maxThresholds of them),
+ * k = 0, ..., _maxK. The most violated function (relative to u(b)) is added with all items, which may still be packed
+ * into bin j.
+ */
+SCIP_RETCODE SepaBinPacking::separateDFF(SCIP* scip, SCIP_SEPA* sepa, int j, SCIP_Bool* cutoff, SCIP_Bool* separated)
+{
+   long long b = _ins->int_b;
+   double    y = _valY[j];
+   if( !_ins->_integral || b <= 0 || b > INT32_MAX || y < 1e-6 )
+      return SCIP_OKAY;
+
+   vector<int> candidate;
+   vector<int> support;
+   vector<long long> threshold = {0};
+   for( int i = 0; i < _ins->_nbItems; ++i )
+   {
+      if( j >= _var_X_begin[i + 1] - _var_X_begin[i] || SCIPvarGetUbLocal(_trans_X[_var_X_begin[i] + j]) < 0.5 )
+         continue;
+
+      candidate.push_back(i);
+      if( _valX[_var_X_begin[i] + j] > 1e-6 )
+      {
+         support.push_back(i);
+         if( 2 * _ins->int_w[i] <= b && (int) threshold.size() < _maxThresholds )
+            threshold.push_back(_ins->int_w[i]);
+      }
+   }
+
+   sort(threshold.begin(), threshold.end());
+   threshold.erase(unique(threshold.begin(), threshold.end()), threshold.end());
+
+   double    bestViolation = 1e-6;
+   long long bestT         = -1;
+   long long bestK         = -1;
+   for( long long t : threshold )
+   {
+      for( long long k = 0; k <= _maxK; ++k )
+      {
+         double activity = 0;
+         for( int i : support )
+         {
+            activity += (double) LowerBound::dff(_ins->int_w[i], b, t, k) * _valX[_var_X_begin[i] + j];
+         }
+
+         double ub        = (double) LowerBound::dff(b, b, t, k);
+         double violation = (activity - ub * y) / ub;
+         if( violation > bestViolation )
+         {
+            bestViolation = violation;
+            bestT         = t;
+            bestK         = k;
+         }
+      }
+   }
+
+   if( bestT == -1 )
+      return SCIP_OKAY;
+
+   vector<int>       item;
+   vector<SCIP_Real> coef;
+   for( int i : candidate )
+   {
+      long long u = LowerBound::dff(_ins->int_w[i], b, bestT, bestK);
+      if( u > 0 )
+      {
+         item.push_back(i);
+         coef.push_back((double) u);
+      }
+   }
+
+   SCIP_Bool added;
+   SCIP_CALL(addCut(scip, sepa, j, item, coef, (double) LowerBound::dff(b, b, bestT, bestK), cutoff, &added));
+   if( added )
+   {
+      ++_nbDFFCuts;
+      *separated = TRUE;
+   }
+
+   return SCIP_OKAY;
+}
+
+/**
+ * @brief separate the LP solution
+ *
+ * @note The local bounds are used to skip items, which can not be packed into a bin any more. The cuts are still
+ * globally valid: an item, which is left out, has the coefficient 0, and a packing with this item only leaves less room
+ * for the items of the cut.
+ */
+SCIP_DECL_SEPAEXECLP(SepaBinPacking::scip_execlp)
+{
+   *result = SCIP_DIDNOTFIND;
+
+   if( _trans_Y.empty() )
+      return SCIP_OKAY;
+
+   _valX.resize(_trans_X.size());
+   for( size_t k = 0; k < _trans_X.size(); ++k )
+   {
+      _valX[k] = SCIPgetSolVal(scip, NULL, _trans_X[k]);
+   }
+
+   _valY.resize(_trans_Y.size());
+   for( size_t j = 0; j < _trans_Y.size(); ++j )
+   {
+      _valY[j] = SCIPgetSolVal(scip, NULL, _trans_Y[j]);
+   }
+
+   SCIP_Bool cutoff    = FALSE;
+   SCIP_Bool separated = FALSE;
+
+   // ###################################################################################################################
+   //  bound cut: sum(j in J, Y_j) >= bound
+   // ###################################################################################################################
+
+   if( !_boundAdded && _bound > 0 )
+   {
+      SCIP_ROW* row;
+      SCIP_CALL(SCIPcreateEmptyRowSepa(scip, &row, sepa, "bound", _bound, SCIPinfinity(scip), FALSE, FALSE, FALSE));
+      SCIP_CALL(SCIPcacheRowExtensions(scip, row));
+      for( SCIP_VAR* var : _trans_Y )
+      {
+         SCIP_CALL(SCIPaddVarToRow(scip, row, var, 1.0));
+      }
+      SCIP_CALL(SCIPflushRowExtensions(scip, row));
+
+      if( SCIPisCutEfficacious(scip, NULL, row) )
+      {
+         SCIP_CALL(SCIPaddRow(scip, row, FALSE, &cutoff));
+         SCIP_CALL(SCIPaddPoolCut(scip, row));
+         _boundAdded = true;
+         separated   = TRUE;
+         ++_nbBoundCuts;
+      }
+
+      SCIP_CALL(SCIPreleaseRow(scip, &row));
+   }
+
+   for( int j = 0; j < (int) _trans_Y.size() && !cutoff; ++j )
+   {
+      // ################################################################################################################
+      //  linking cuts: X_ij <= Y_j
+      // ################################################################################################################
+
+      for( int i = 0; i < _ins->_nbItems && !cutoff; ++i )
+      {
+         if( j >= _var_X_begin[i + 1] - _var_X_begin[i] || _valX[_var_X_begin[i] + j] <= _valY[j] + 1e-6 )
+            continue;
+
+         SCIP_Bool added;
+         SCIP_CALL(addCut(scip, sepa, j, {i}, {1.0}, 1.0, &cutoff, &added));
+         if( added )
+         {
+            ++_nbLinkingCuts;
+            separated = TRUE;
+         }
+      }
+
+      // ################################################################################################################
+      //  lifted cover cuts and dual feasible function cuts
+      // ################################################################################################################
+
+      if( !cutoff )
+      {
+         if( _ins->_integral )
+            SCIP_CALL(separateCover(scip, sepa, j, _ins->int_w, _ins->int_b, &cutoff, &separated));
+         else
+            SCIP_CALL(separateCover(scip, sepa, j, _ins->par_w, _ins->par_b, &cutoff, &separated));
+      }
+
+      if( !cutoff )
+         SCIP_CALL(separateDFF(scip, sepa, j, &cutoff, &separated));
+   }
+
+   if( cutoff )
+      *result = SCIP_CUTOFF;
+   else if( separated )
+      *result = SCIP_SEPARATED;
+
+   return SCIP_OKAY;
+}
@@ -0,0 +1,99 @@
+// SepaBinPacking.h
+#pragma once
+
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief separator for problem-specific cutting planes of the compact model
+ *
+ * @param _ins pointer to the instance
+ *
+ * @param _var_X, _var_X_begin, _var_Y (original) variables of the compact model, see CompactModel
+ *
+ * @param _trans_X, _trans_Y transformed variables, set at the start of every solve
+ *
+ * @param _nbLinkingCuts, _nbCoverCuts, _nbDFFCuts, _nbBoundCuts number of cuts of every family added to the LP
+ *
+ * @note The LP relaxation of the compact model only reaches the continuous bound sum(w_i) / b. The separator adds
+ * - linking cuts X_ij <= Y_j, the disaggregated form of the capacity and linking constraint,
+ * - lifted cover cuts: a cover C of bin j (items, which do not fit together) gives sum(i in C, X_ij) <= (|C| - 1) Y_j.
+ *   The cover is built greedily from the LP solution and made minimal, then the other candidates of bin j are lifted
+ *   sequentially (by decreasing LP value). The lifting coefficients are integral, so the lifting problem is solved
+ *   exactly by a dynamic program over the value of the left-hand side (minimal weight of every value).
+ * - dual feasible function cuts sum(i in I, u(w_i) X_ij) <= u(b) Y_j for the functions of LowerBound::dff() with the
+ *   weights of the LP support of bin j as thresholds, only for integral weights (see Instance::setIntegral()),
+ * - the bound cut sum(j in J, Y_j) >= L, the Chvatal-Gomory rounding of the dual feasible function cuts summed over
+ *   all bins, with L the best bound of LowerBound over the items, which have not been removed. It is added once per
+ *   solve.
+ * All cuts are globally valid. Only the most violated cover cut and dual feasible function cut of every bin are added
+ * per round.
+ */
+class SepaBinPacking : public ObjSepa
+{
+public:
+   // constructor
+   SepaBinPacking(SCIP*                    scip,
+                  Instance*                ins,
+                  const vector<SCIP_VAR*>& var_X,
+                  const vector<int>&       var_X_begin,
+                  const vector<SCIP_VAR*>& var_Y,
+                  int                      freq);
+
+   // destructor
+   virtual ~SepaBinPacking() {}
+
+   virtual SCIP_DECL_SEPAINITSOL(scip_initsol);
+   virtual SCIP_DECL_SEPAEXECLP(scip_execlp);
+
+   long long _nbLinkingCuts; // number of linking cuts
+   long long _nbCoverCuts;   // number of lifted cover cuts
+   long long _nbDFFCuts;     // number of dual feasible function cuts
+   long long _nbBoundCuts;   // number of bound cuts
+
+private:
+   // separate the lifted cover cuts of bin j with weights of type W (double or long long)
+   template <typename W>
+   SCIP_RETCODE separateCover(SCIP*            scip,
+                              SCIP_SEPA*       sepa,
+                              int              j,
+                              const vector<W>& weight,
+                              W                capacity,
+                              SCIP_Bool*       cutoff,
+                              SCIP_Bool*       separated);
+
+   // separate the dual feasible function cuts of bin j
+   SCIP_RETCODE separateDFF(SCIP* scip, SCIP_SEPA* sepa, int j, SCIP_Bool* cutoff, SCIP_Bool* separated);
+
+   // add the cut sum(k, coef_k X_{item_k j}) <= rhs Y_j, if it is efficacious
+   SCIP_RETCODE addCut(SCIP*                    scip,
+                       SCIP_SEPA*               sepa,
+                       int                      j,
+                       const vector<int>&       item,
+                       const vector<SCIP_Real>& coef,
+                       SCIP_Real                rhs,
+                       SCIP_Bool*               cutoff,
+                       SCIP_Bool*               added);
+
+   Instance* _ins; // pointer to the instance
+
+   const vector<SCIP_VAR*>& _var_X;       // X_ij of the compact model, X_ij at position _var_X_begin[i] + j
+   const vector<int>&       _var_X_begin; // first position of the variables of item i in _var_X
+   const vector<SCIP_VAR*>& _var_Y;       // Y_j of the compact model
+
+   vector<SCIP_VAR*> _trans_X; // transformed X_ij, same positions as _var_X
+   vector<SCIP_VAR*> _trans_Y; // transformed Y_j
+
+   vector<double> _valX; // LP values of the transformed X_ij of the current round
+   vector<double> _valY; // LP values of the transformed Y_j of the current round
+
+   int  _bound;      // best lower bound on the number of bins of the current solve
+   bool _boundAdded; // true, if the bound cut has been added in the current solve
+
+   int _maxThresholds; // maximal number of thresholds t of the dual feasible functions per bin
+   int _maxK;          // maximal parameter k of the dual feasible functions
+};
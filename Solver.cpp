@@ -0,0 +1,554 @@
+// Solver.cpp
+#include "Solver.h"
+#include "ArcFlowModel.h"
+#include "BranchAndBound.h"
+#include "CompactModel.h"
+#include "EventTelemetry.h"
+#include "Heuristic.h"
+#include "LowerBound.h"
+#include "PatternModel.h"
+#include "Portfolio.h"
+#include "Reduction.h"
+#include "StreamHeuristic.h"
+
+#include <chrono>
+#include <climits>
+
+/**
+ * @brief the SCIP status as a short string
+ */
+static string statusName(SCIP_STATUS status)
+{
+   switch( status )
+   {
+   case SCIP_STATUS_OPTIMAL:
+      return "optimal";
+   case SCIP_STATUS_INFEASIBLE:
+      return "infeasible";
+   case SCIP_STATUS_TIMELIMIT:
+      return "timelimit";
+   case SCIP_STATUS_MEMLIMIT:
+      return "memlimit";
+   case SCIP_STATUS_NODELIMIT:
+   case SCIP_STATUS_TOTALNODELIMIT:
+   case SCIP_STATUS_STALLNODELIMIT:
+      return "nodelimit";
+   case SCIP_STATUS_GAPLIMIT:
+      return "gaplimit";
+   case SCIP_STATUS_USERINTERRUPT:
+   case SCIP_STATUS_TERMINATE:
+      return "interrupted";
+   default:
+      return "unknown";
+   }
+}
+
+/**
+ * @brief escape a string for a JSON string literal
+ */
+string escapeJSON(const string& s)
+{
+   string escaped;
+   for( char c : s )
+   {
+      if( c == '"' || c == '\\' )
+         escaped += '\\';
+      escaped += c;
+   }
+   return escaped;
+}
+
+/**
+ * @brief the header of the CSV file, the columns match toCSV()
+ */
+string SolveResult::headerCSV()
+{
+   return "instance,model,status,bins,bound,gap,time,read_time,build_time,solve_time";
+}
+
+/**
+ * @brief the result as a single CSV line
+ *
+ * @note The instance path is quoted, as it may contain commas, and its quotes are doubled.
+ */
+string SolveResult::toCSV() const
+{
+   string instance;
+   for( char c : _instance )
+   {
+      instance += c == '"' ? "\"\"" : string(1, c);
+   }
+
+   ostringstream line;
+   line << "\"" << instance << "\"," << _model << "," << _status << "," << _bins << "," << _bound << "," << _gap
+        << "," << _time << "," << _readTime << "," << _buildTime << "," << _solveTime;
+   return line.str();
+}
+
+/**
+ * @brief the result as a single JSON object
+ */
+string SolveResult::toJSON() const
+{
+   ostringstream line;
+   line << "{\"instance\":\"" << escapeJSON(_instance) << "\",\"model\":\"" << _model << "\",\"status\":\"" << _status
+        << "\",\"bins\":" << _bins << ",\"bound\":" << _bound << ",\"gap\":" << _gap << ",\"time\":" << _time
+        << ",\"read_time\":" << _readTime << ",\"build_time\":" << _buildTime << ",\"solve_time\":" << _solveTime;
+   if( !_statistics.empty() )
+      line << ",\"statistics\":" << _statistics;
+   if( !_packing.empty() )
+   {
+      line << ",\"packing\":[";
+      for( size_t i = 0; i < _packing.size(); ++i )
+      {
+         line << (i > 0 ? "," : "") << _packing[i];
+      }
+      line << "]";
+   }
+   line << "}";
+   return line.str();
+}
+
+/**
+ * @brief read the status, the bounds and the gap of a solved SCIP environment into the result
+ *
+ * @param scip pointer to the scip environment after SCIPsolve
+ *
+ * @param result result, in which the values are stored
+ *
+ * @param telemetry event handler of the telemetry or NULL; if given, the statistics are stored as JSON in the result
+ */
+void readSCIPResult(SCIP* scip, SolveResult& result, EventTelemetry* telemetry)
+{
+   result._status    = statusName(SCIPgetStatus(scip));
+   result._bins      = SCIPgetNSols(scip) > 0 ? SCIPgetPrimalbound(scip) : -1;
+   result._bound     = SCIPgetDualbound(scip);
+   result._gap       = SCIPgetGap(scip);
+   result._solveTime = SCIPgetSolvingTime(scip);
+
+   if( telemetry != NULL )
+   {
+      telemetry->finish(scip);
+      result._statistics = statisticsJSON(scip, telemetry);
+   }
+}
+
+/**
+ * @brief add the bins fixed by the reduction to the bounds of the result
+ *
+ * @param result result of the residual instance
+ *
+ * @param nbFixedBins number of bins fixed by the reduction
+ *
+ * @note The gap is computed again like the gap of SCIP: (bins - bound) / bound.
+ */
+static void addFixedBins(SolveResult& result, int nbFixedBins)
+{
+   if( result._bins >= 0 )
+      result._bins += nbFixedBins;
+   result._bound += nbFixedBins;
+
+   if( result._bins >= 0 && result._bound > 0 )
+      result._gap = (result._bins - result._bound) / result._bound;
+}
+
+/**
+ * @brief set the parameters of the settings in a built model, before it is solved
+ *
+ * @param scip pointer to the scip environment of the model
+ *
+ * @param settings settings of the solve
+ *
+ * @return the event handler of the telemetry, if it is switched on, NULL otherwise
+ *
+ * @note The event handler is owned by SCIP and freed together with the SCIP environment.
+ */
+static EventTelemetry* prepareSCIP(SCIP* scip, const SolverSettings& settings)
+{
+   SCIPsetRealParam(scip, "limits/time", settings._timeLimit);
+   if( !settings._verbose )
+      SCIPsetMessagehdlrQuiet(scip, TRUE);
+
+   if( !settings._telemetry )
+      return NULL;
+
+   EventTelemetry* telemetry = new EventTelemetry(scip);
+   SCIPincludeObjEventhdlr(scip, telemetry, TRUE);
+   return telemetry;
+}
+
+/**
+ * @brief store the packings of the streaming heuristic in the result
+ *
+ * @param heur streaming heuristic after StreamHeuristic::finish()
+ *
+ * @param result result, in which the values are stored
+ *
+ * @note The bound is L1, so the packing is only proven optimal, if it reaches L1, the status is "feasible" otherwise.
+ */
+static void readStreamResult(const StreamHeuristic* heur, SolveResult& result)
+{
+   if( !heur->_feasible )
+   {
+      result._status = "infeasible";
+      return;
+   }
+
+   result._status = heur->_nbBinsUsed <= heur->_L1 ? "optimal" : "feasible";
+   result._bins   = heur->_nbBinsUsed;
+   result._bound  = heur->_L1;
+   result._gap    = heur->_L1 > 0 ? (result._bins - result._bound) / result._bound : 0;
+}
+
+/**
+ * @brief pack a single instance file by the streaming heuristic, while it is read
+ *
+ * @param fileName path to the .bpp-file
+ *
+ * @param settings parameters of the solve, the packing is written into the packing file, if there is one
+ *
+ * @return the result of the heuristic, status "error" if the file is malformed or the packing file can not be opened
+ *
+ * @note The instance is never stored (see StreamHeuristic), so the read time is part of the solve time.
+ */
+static SolveResult streamInstance(const string& fileName, const SolverSettings& settings)
+{
+   auto start = chrono::steady_clock::now();
+
+   SolveResult result;
+   result._instance = fileName;
+   result._model    = "stream";
+
+   ofstream packing;
+   if( !settings._packingFile.empty() )
+   {
+      packing.open(settings._packingFile);
+      if( !packing )
+      {
+         cerr << "streamInstance : can not open the packing file " << settings._packingFile << "\n";
+         result._status = "error";
+         return result;
+      }
+   }
+
+   StreamHeuristic* heur = new StreamHeuristic();
+   if( heur->run(fileName, packing.is_open() ? &packing : nullptr) )
+   {
+      readStreamResult(heur, result);
+      if( settings._verbose )
+         heur->display();
+   }
+   else
+      result._status = "error";
+   delete heur;
+
+   result._time      = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   result._solveTime = result._time;
+
+   return result;
+}
+
+/**
+ * @brief solve a single instance file
+ *
+ * @param fileName path to the .bpp-file
+ *
+ * @param settings model and parameters of the solve
+ *
+ * @return the result of the solve
+ *
+ * @note The instance is read and solved by solveInstance(Instance*, ...). Every call creates and frees its own
+ * Instance, model and SCIP environment, so it can be called from several threads at the same time. If the instance can
+ * not be read, the status of the result is "error". The streaming heuristic packs the file, while it is read, the
+ * instance is not stored (see streamInstance()).
+ */
+SolveResult solveInstance(const string& fileName, const SolverSettings& settings)
+{
+   if( settings._model == "stream" )
+      return streamInstance(fileName, settings);
+
+   auto start = chrono::steady_clock::now();
+
+   Instance* ins      = new Instance();
+   bool      read     = ins->read(fileName);
+   double    readTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   SolveResult result;
+   if( read )
+      result = solveInstance(ins, settings);
+   else
+   {
+      result._model  = settings._model == "compact" && settings._symmetryBreaking ? "compact_sym" : settings._model;
+      result._status = "error";
+   }
+
+   result._instance = fileName;
+   result._readTime = readTime;
+   result._time     = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   delete ins;
+
+   return result;
+}
+
+/**
+ * @brief solve an instance in memory
+ *
+ * @param ins pointer to the instance, it stays owned by the caller, its number of bins is changed
+ *
+ * @param settings model and parameters of the solve
+ *
+ * @param scip empty SCIP environment with the default plugins, which is borrowed by the compact model (see
+ * SolverService), NULL: every model creates its own environment
+ *
+ * @return the result of the solve, the instance name is empty
+ *
+ * @note This function contains the complete solving process of a single instance: it reduces the instance (see
+ * Reduction), runs the heuristic on the residual instance to reduce the number of bins, creates the selected model,
+ * passes the heuristic packing as starting solution and solves the model. The bins fixed by the reduction are added
+ * to the bounds of the result, and the packing of the residual instance is mapped back to the full instance. The
+ * streaming heuristic packs the weights in their order without the reduction and the other heuristics. If the
+ * settings are not verbose, nothing is printed.
+ */
+SolveResult solveInstance(Instance* ins, const SolverSettings& settings, SCIP* scip)
+{
+   auto start = chrono::steady_clock::now();
+
+   SolveResult result;
+   result._model = settings._model == "compact" && settings._symmetryBreaking ? "compact_sym" : settings._model;
+
+   // the streaming heuristic needs neither the reduction nor a model
+   if( settings._model == "stream" )
+   {
+      StreamHeuristic* heur = new StreamHeuristic();
+      heur->start(ins->par_b);
+      for( double weight : ins->par_w )
+      {
+         heur->add(weight);
+      }
+      heur->finish();
+      readStreamResult(heur, result);
+      delete heur;
+
+      result._solveTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      return result;
+   }
+
+   if( settings._verbose )
+      ins->display();
+
+   //#####################################################################################################################
+   // reduce the instance: the models only see the residual instance, the fixed bins are added to the result
+   Instance*   full = ins;
+   Reduction*  red  = nullptr;
+   vector<int> packing;        // bin of every item of the residual instance in the best packing
+   bool        packed = false; // true, if the packing is known
+   if( settings._reduce )
+   {
+      red = new Reduction(full);
+      ins = red->run();
+      if( settings._verbose )
+         red->display();
+   }
+
+   //#####################################################################################################################
+   // run the heuristic: its number of bins is an upper bound, so the set of bins J can be reduced to it
+   Heuristic* heur = new Heuristic(ins);
+   heur->run();
+   if( settings._verbose )
+      heur->display();
+
+   if( heur->_feasible )
+      ins->_nbBins = heur->_nbBinsUsed;
+
+   //#####################################################################################################################
+   // compute the lower bounds: if the heuristic reaches the best bound, its packing is optimal and no model is needed
+   LowerBound* bound = nullptr;
+   if( settings._bounds && heur->_feasible )
+   {
+      bound = new LowerBound(ins);
+      bound->run(heur->_nbBinsUsed);
+      if( settings._verbose )
+         bound->display();
+   }
+
+   //#####################################################################################################################
+   // create and solve the model
+   auto buildStart = chrono::steady_clock::now();
+
+   // the arc-flow model needs integral weights, otherwise the pattern model is used, which has the same LP bound
+   if( settings._model == "arcflow" && !ArcFlowModel::isApplicable(ins) )
+   {
+      if( settings._verbose )
+         cout << "arc-flow model needs an integral capacity and integral weights, the pattern model is used\n";
+      result._model = "pattern";
+   }
+
+   // the same holds for the branch-and-bound
+   if( settings._model == "bnb" && !BranchAndBound::isApplicable(ins) )
+   {
+      if( settings._verbose )
+         cout << "branch-and-bound needs an integral capacity and integral weights, the pattern model is used\n";
+      result._model = "pattern";
+   }
+
+   if( ins->_nbItems == 0 )
+   {
+      // the reduction has fixed all items, no model is needed
+      result._status = "optimal";
+      result._bins   = 0;
+      result._bound  = 0;
+      result._gap    = 0;
+      packed         = true;
+   }
+   else if( bound != nullptr && bound->_best >= heur->_nbBinsUsed )
+   {
+      // the heuristic packing is optimal
+      result._status = "optimal";
+      result._bins   = heur->_nbBinsUsed;
+      result._bound  = heur->_nbBinsUsed;
+      result._gap    = 0;
+      packing        = heur->_bin_of_item;
+      packed         = true;
+   }
+   else if( result._model == "bnb" )
+   {
+      // no model is built, the search works directly on the instance
+      BranchAndBound* bnb = new BranchAndBound(ins);
+      result._buildTime   = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+      auto solveStart = chrono::steady_clock::now();
+      bnb->run(heur, settings._timeLimit);
+      result._solveTime = chrono::duration<double>(chrono::steady_clock::now() - solveStart).count();
+
+      if( settings._verbose )
+         bnb->display();
+
+      if( !bnb->_feasible )
+         result._status = "infeasible";
+      else if( !bnb->verify() )
+         result._status = "error";
+      else
+      {
+         result._status = bnb->_optimal ? "optimal" : "timelimit";
+         result._bins   = bnb->_nbBinsUsed;
+         result._bound  = bnb->_lowerBound;
+         result._gap    = bnb->_optimal ? 0 : (result._bins - result._bound) / result._bound;
+         packing        = bnb->_bin_of_item;
+         packed         = true;
+      }
+
+      if( settings._telemetry )
+      {
+         ostringstream statistics;
+         statistics << "{\"solving_time\":" << result._solveTime << ",\"nodes\":" << bnb->_nbNodes << "}";
+         result._statistics = statistics.str();
+      }
+      delete bnb;
+   }
+   else if( result._model == "arcflow" )
+   {
+      ArcFlowModel* arcMod = new ArcFlowModel(ins);
+      arcMod->addStartSolution(heur);
+      result._buildTime = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+      EventTelemetry* telemetry = prepareSCIP(arcMod->getSCIP(), settings);
+
+      arcMod->solve();
+      if( settings._verbose )
+         arcMod->displaySolution();
+
+      readSCIPResult(arcMod->getSCIP(), result, telemetry);
+      delete arcMod;
+   }
+   else if( result._model == "pattern" )
+   {
+      PatternModel* patMod = new PatternModel(ins);
+      patMod->addStartSolution(heur);
+      result._buildTime = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+      EventTelemetry* telemetry = prepareSCIP(patMod->getSCIP(), settings);
+
+      patMod->solve();
+      if( settings._verbose )
+         patMod->displaySolution();
+
+      readSCIPResult(patMod->getSCIP(), result, telemetry);
+      delete patMod;
+   }
+   else if( result._model == "portfolio" )
+   {
+      // several configurations of the compact model race on separate threads
+      Portfolio* portfolio = new Portfolio(ins, settings, settings._portfolioSize);
+      result._buildTime    = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+      auto solveStart = chrono::steady_clock::now();
+      portfolio->run(heur);
+      result._solveTime = chrono::duration<double>(chrono::steady_clock::now() - solveStart).count();
+
+      if( settings._verbose )
+         portfolio->display();
+
+      result._status = portfolio->_status;
+      result._bins   = portfolio->_bestBins < INT_MAX ? portfolio->_bestBins.load() : -1;
+      result._bound  = portfolio->_bound;
+      result._gap    = result._bins >= 0 && result._bound > 0 ? (result._bins - result._bound) / result._bound : 1e+20;
+      packing        = portfolio->bestPacking();
+      packed         = !packing.empty();
+
+      if( settings._telemetry )
+         result._statistics = portfolio->toJSON();
+      delete portfolio;
+   }
+   else
+   {
+      CompactModel* compMod = new CompactModel(ins, settings._symmetryBreaking, settings._production, scip);
+      if( settings._binPacking )
+         compMod->addBinPackingConstraint();
+      if( settings._roundingFreq >= 0 )
+         compMod->addRoundingHeuristic(settings._roundingFreq);
+      if( settings._cutsFreq >= 0 )
+         compMod->addSeparator(settings._cutsFreq);
+      compMod->addStartSolution(heur);
+      result._buildTime = chrono::duration<double>(chrono::steady_clock::now() - buildStart).count();
+
+      if( !settings._lpFile.empty() )
+         compMod->writeLP(settings._lpFile);
+
+      EventTelemetry* telemetry = prepareSCIP(compMod->getSCIP(), settings);
+
+      compMod->solve();
+      if( settings._verbose )
+         compMod->displaySolution();
+
+      readSCIPResult(compMod->getSCIP(), result, telemetry);
+      packing = compMod->getPacking();
+      packed  = !packing.empty();
+      delete compMod;
+   }
+
+   // the bound may be stronger than the bound of a model stopped by the time limit
+   if( bound != nullptr && result._bins >= 0 && bound->_best > result._bound )
+   {
+      result._bound = bound->_best;
+      result._gap   = result._bins > result._bound ? (result._bins - result._bound) / result._bound : 0;
+      if( result._gap == 0 )
+         result._status = "optimal";
+   }
+
+   if( settings._packing && packed )
+      result._packing = red != nullptr ? red->expand(packing) : packing;
+
+   if( red != nullptr )
+   {
+      addFixedBins(result, red->nbFixedBins());
+      delete red; // frees the residual instance
+   }
+
+   delete bound;
+   delete heur;
+
+   result._time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   return result;
+}
@@ -0,0 +1,114 @@
+// Solver.h
+#pragma once
+
+#include "EventTelemetry.h"
+#include "Instance.h"
+
+/* scip includes */
+#include "objscip/objscip.h"
+
+using namespace scip;
+
+/**
+ * @brief settings of a single solve, shared by the single instance mode and the batch mode of main()
+ *
+ * @param _model name of the model: "compact", "pattern", "arcflow", "bnb", "portfolio" (see Portfolio) or
+ * "stream" (see StreamHeuristic)
+ *
+ * @param _symmetryBreaking compact model only: item i only in bins j <= i and Y_j >= Y_{j+1}
+ *
+ * @param _timeLimit time limit for SCIP or the branch-and-bound in seconds
+ *
+ * @param _production compact model only: build the model without names
+ *
+ * @param _lpFile if not empty, the LP-model of the compact model is written into this file (single instance only)
+ *
+ * @param _verbose true: display the instance, the heuristic and the solution and print the SCIP output
+ *
+ * @param _reduce true: reduce the instance before the model is built (see Reduction)
+ *
+ * @param _binPacking compact model only: add the global bin-packing constraint (see ConsBinPacking)
+ *
+ * @param _roundingFreq compact model only: frequency of the LP rounding heuristic (see HeurRounding), -1: off
+ *
+ * @param _cutsFreq compact model only: frequency of the separator of problem-specific cuts (see SepaBinPacking), -1: off
+ *
+ * @param _portfolioSize portfolio only: number of configurations of the compact model, <= 0: one per core (the batch
+ * and service modes divide the cores by the number of parallel jobs)
+ *
+ * @param _packingFile stream model only: if not empty, the bins of every item are written into this file (single
+ * instance only)
+ *
+ * @param _bounds true: compute the lower bounds and skip the model, if the heuristic packing reaches them
+ *
+ * @param _packing true: store the best packing of the full instance in the result (heuristic, compact model,
+ * portfolio and branch-and-bound only)
+ *
+ * @param _telemetry true: record the bound trajectory and store the statistics of the solve as JSON in the result
+ */
+struct SolverSettings
+{
+   string _model            = "compact";
+   bool   _symmetryBreaking = false;
+   double _timeLimit        = 1e+20;
+   bool   _production       = false;
+   string _lpFile           = "";
+   bool   _verbose          = true;
+   bool   _reduce           = true;
+   bool   _bounds           = true;
+   bool   _binPacking       = false;
+   int    _roundingFreq     = -1;
+   int    _cutsFreq         = -1;
+   int    _portfolioSize    = 0;
+   string _packingFile      = "";
+   bool   _packing          = false;
+   bool   _telemetry        = false;
+};
+
+/**
+ * @brief result of a single solve
+ *
+ * @note The number of bins is the primal bound (-1, if no packing was found), the bound is the dual bound of SCIP or
+ * the bound of the branch-and-bound. The time is the wall-clock time of the whole solve including reading the instance
+ * and building the model. The read time is the wall-clock time of Instance::read(). The build time is the wall-clock
+ * time to create the model (including the SCIP environment and the starting solution), the solve time is the solving
+ * time measured by SCIP or the time of the branch-and-bound.
+ */
+struct SolveResult
+{
+   string      _instance;          // path of the instance file, id of a job of the SolverService
+   string      _model;             // name of the model
+   string      _status;            // solving status, e.g. "optimal", "infeasible", "timelimit", "error"
+   double      _bins      = -1;    // number of bins of the best packing, -1 if there is none
+   double      _bound     = 0;     // lower bound on the number of bins
+   double      _gap       = 1e+20; // relative gap between the number of bins and the bound
+   double      _time      = 0;     // wall-clock time in seconds
+   double      _readTime  = 0;     // time to read the instance in seconds
+   double      _buildTime = 0;     // time to build the model in seconds
+   double      _solveTime = 0;     // time of SCIPsolve in seconds
+   string      _statistics;        // statistics as a JSON object, only with telemetry, see statisticsJSON()
+   vector<int> _packing;           // bin of every item of the full instance, only on request, empty if unknown
+
+   // the result as a single CSV line (without line break)
+   string toCSV() const;
+
+   // the result as a single JSON object (without line break), including the statistics and the packing, if there are
+   // any
+   string toJSON() const;
+
+   // the header of the CSV file
+   static string headerCSV();
+};
+
+// escape a string for a JSON string literal
+string escapeJSON(const string& s);
+
+// read the status, the bounds and the gap of a solved SCIP environment into the result, and the statistics, if the
+// telemetry is given
+void readSCIPResult(SCIP* scip, SolveResult& result, EventTelemetry* telemetry = NULL);
+
+// solve a single instance file with the given settings
+SolveResult solveInstance(const string& fileName, const SolverSettings& settings);
+
+// solve an instance in memory with the given settings, the compact model borrows the SCIP environment, if it is given
+SolveResult solveInstance(Instance* ins, const SolverSettings& settings, SCIP* scip = NULL);
@@ -0,0 +1,550 @@
+// SolverService.cpp
+#include "SolverService.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "objscip/objscipdefplugins.h"
+
+/**
+ * @brief Construct a new SolverService:: SolverService object
+ *
+ * @param settings settings used for every job, the plugins of the compact model and the output are switched off
+ *
+ * @param nbWorkers number of jobs solved at the same time, at least 1, and of the SCIP environments of the compact model
+ */
+SolverService::SolverService(const SolverSettings& settings, int nbWorkers)
+{
+   _nbWorkers              = max(nbWorkers, 1);
+   _settings               = settings;
+   _settings._verbose      = false;
+   _settings._packing      = true;
+   _settings._lpFile       = "";
+   _settings._packingFile  = "";
+   _settings._binPacking   = false;
+   _settings._roundingFreq = -1;
+   _settings._cutsFreq     = -1;
+   _settings._telemetry    = false;
+
+   for( int k = 0; k < _nbWorkers && _settings._model == "compact"; ++k )
+   {
+      SCIP* scip;
+      SCIPcreate(&scip);
+      SCIPincludeDefaultPlugins(scip);
+      SCIPsetMessagehdlrQuiet(scip, TRUE);
+      _pool.push_back(scip);
+   }
+   _idle = _pool;
+}
+
+/**
+ * @brief Destroy the SolverService:: SolverService object
+ *
+ * @note No job may be running, all environments have to be idle.
+ */
+SolverService::~SolverService()
+{
+   for( SCIP* scip : _pool )
+   {
+      SCIPfree(&scip);
+   }
+}
+
+/**
+ * @brief take an idle environment
+ */
+SCIP* SolverService::acquire()
+{
+   unique_lock<mutex> lock(_poolMutex);
+   _released.wait(lock, [this] { return !_idle.empty(); });
+
+   SCIP* scip = _idle.back();
+   _idle.pop_back();
+   return scip;
+}
+
+/**
+ * @brief return an environment to the pool, its problem has been freed by the model
+ */
+void SolverService::release(SCIP* scip)
+{
+   {
+      lock_guard<mutex> lock(_poolMutex);
+      _idle.push_back(scip);
+   }
+   _released.notify_one();
+}
+
+/**
+ * @brief true, if the model returns the packing of a job
+ *
+ * @note The pattern model, the arc-flow model and the stream model do not extract the bin of every item from their
+ * solutions, so their answers would miss the packing.
+ */
+bool SolverService::supportsModel(const string& model)
+{
+   return model == "compact" || model == "portfolio" || model == "bnb";
+}
+
+// #####################################################################################################################
+//  parsing of the jobs
+// #####################################################################################################################
+
+static void skipSpace(const string& s, size_t& p)
+{
+   while( p < s.size() && isspace((unsigned char) s[p]) )
+      ++p;
+}
+
+// parse a JSON string starting at s[p], the escapes \" \\ \/ \n \t are resolved
+static bool parseString(const string& s, size_t& p, string& value)
+{
+   if( p >= s.size() || s[p] != '"' )
+      return false;
+
+   value.clear();
+   for( ++p; p < s.size() && s[p] != '"'; ++p )
+   {
+      if( s[p] == '\\' && p + 1 < s.size() )
+      {
+         ++p;
+         value += s[p] == 'n' ? '\n' : (s[p] == 't' ? '\t' : s[p]);
+      }
+      else
+         value += s[p];
+   }
+
+   if( p >= s.size() )
+      return false;
+
+   ++p;
+   return true;
+}
+
+// parse a JSON number starting at s[p], strtod() also accepts nan and inf, which are no JSON numbers
+static bool parseNumber(const string& s, size_t& p, double& value)
+{
+   const char* begin = s.c_str() + p;
+   char*       end;
+   value = strtod(begin, &end);
+   if( end == begin || !isfinite(value) )
+      return false;
+
+   p += end - begin;
+   return true;
+}
+
+/**
+ * @brief parse a job
+ *
+ * @param line JSON object of the job
+ *
+ * @param id returns the id of the job, empty if it has none
+ *
+ * @param ins returns the instance of "capacity" and "weights" or of "file"
+ *
+ * @param file returns the path of "file", empty if the instance is given directly
+ *
+ * @param timeLimit returns the time limit of the job, unchanged if it has none
+ *
+ * @param error returns the reason, if the job is malformed
+ *
+ * @note Only flat objects are accepted: the values are strings, numbers, true, false, null or the array of weights.
+ * Unknown keys are ignored.
+ */
+bool SolverService::parseJob(const string& line,
+                             string&       id,
+                             Instance*     ins,
+                             string&       file,
+                             double&       timeLimit,
+                             string&       error)
+{
+   size_t p        = 0;
+   double capacity = -1;
+   bool   weights  = false;
+
+   skipSpace(line, p);
+   if( p >= line.size() || line[p] != '{' )
+   {
+      error = "expected a JSON object";
+      return false;
+   }
+   ++p;
+   skipSpace(line, p);
+
+   while( p < line.size() && line[p] != '}' )
+   {
+      string key;
+      if( !parseString(line, p, key) )
+      {
+         error = "expected a key";
+         return false;
+      }
+      skipSpace(line, p);
+      if( p >= line.size() || line[p] != ':' )
+      {
+         error = "expected ':' after \"" + key + "\"";
+         return false;
+      }
+      ++p;
+      skipSpace(line, p);
+
+      bool   ok = true;
+      double value;
+      if( key == "id" )
+      {
+         size_t begin = p;
+         if( p < line.size() && line[p] == '"' )
+            ok = parseString(line, p, id);
+         else if( (ok = parseNumber(line, p, value)) )
+            id = line.substr(begin, p - begin);
+      }
+      else if( key == "capacity" )
+         ok = parseNumber(line, p, capacity);
+      else if( key == "time_limit" )
+         ok = parseNumber(line, p, timeLimit);
+      else if( key == "file" )
+         ok = parseString(line, p, file);
+      else if( key == "weights" )
+      {
+         ok      = p < line.size() && line[p] == '[';
+         weights = true;
+         ins->par_w.clear();
+         for( ++p, skipSpace(line, p); ok && p < line.size() && line[p] != ']'; skipSpace(line, p) )
+         {
+            ok = parseNumber(line, p, value);
+            ins->par_w.push_back(value);
+            skipSpace(line, p);
+            if( p < line.size() && line[p] == ',' )
+               ++p;
+         }
+         ok = ok && p < line.size();
+         ++p;
+      }
+      else if( p < line.size() && line[p] == '"' )
+         ok = parseString(line, p, key);
+      else if( line.compare(p, 4, "true") == 0 || line.compare(p, 4, "null") == 0 )
+         p += 4;
+      else if( line.compare(p, 5, "false") == 0 )
+         p += 5;
+      else
+         ok = parseNumber(line, p, value);
+
+      if( !ok )
+      {
+         error = "malformed value of \"" + key + "\"";
+         return false;
+      }
+
+      skipSpace(line, p);
+      if( p < line.size() && line[p] == ',' )
+      {
+         ++p;
+         skipSpace(line, p);
+      }
+   }
+
+   if( p >= line.size() )
+   {
+      error = "expected '}'";
+      return false;
+   }
+
+   // #####################################################################################################################
+   //  the instance
+
+   if( !file.empty() )
+   {
+      if( !ins->read(file) )
+      {
+         error = "can not read the instance file " + file;
+         return false;
+      }
+      return true;
+   }
+
+   if( !weights || capacity <= 0 )
+   {
+      error = "expected \"file\" or a positive \"capacity\" and \"weights\"";
+      return false;
+   }
+
+   for( double w : ins->par_w )
+   {
+      if( w < 0 )
+      {
+         error = "negative weight";
+         return false;
+      }
+   }
+
+   ins->par_b    = capacity;
+   ins->_nbItems = (int) ins->par_w.size();
+   ins->_nbBins  = ins->_nbItems;
+   ins->setIntegral();
+
+   return true;
+}
+
+// #####################################################################################################################
+//  solving
+// #####################################################################################################################
+
+/**
+ * @brief solve a single job
+ *
+ * @param line JSON object of the job
+ *
+ * @return the answer as a JSON line: the result with the packing or the error
+ *
+ * @note The time of the result includes parsing the job (the read time) and waiting for an idle environment. Only the
+ * compact model creates its problem in a borrowed environment, the other models create their own environments or need
+ * none, so they do not wait for the pool.
+ */
+string SolverService::solveJob(const string& line)
+{
+   auto start = chrono::steady_clock::now();
+
+   Instance* ins = new Instance();
+   string    id, file, error;
+   double    timeLimit = _settings._timeLimit;
+
+   if( !parseJob(line, id, ins, file, timeLimit, error) )
+   {
+      delete ins;
+      return "{\"instance\":\"" + escapeJSON(id) + "\",\"status\":\"error\",\"message\":\"" + escapeJSON(error) + "\"}";
+   }
+   double readTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   SolverSettings settings = _settings;
+   settings._timeLimit     = timeLimit;
+
+   SCIP*       scip   = settings._model == "compact" ? acquire() : NULL;
+   SolveResult result = solveInstance(ins, settings, scip);
+   if( scip != NULL )
+      release(scip);
+
+   result._instance = id.empty() ? file : id;
+   result._readTime = readTime;
+   result._time     = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   delete ins;
+
+   return result.toJSON();
+}
+
+/**
+ * @brief answer the jobs of a stream
+ *
+ * @param in stream of jobs, one per line, empty lines are skipped
+ *
+ * @param out stream of the answers, one per line, flushed after every answer
+ *
+ * @note One worker thread per environment takes the jobs from a queue, so the answers are written in the order of
+ * completion, the "instance" field identifies the job. The function returns, when the stream has ended and all jobs
+ * are answered.
+ */
+void SolverService::serve(istream& in, ostream& out)
+{
+   deque<string>      jobs;
+   mutex              jobMutex;
+   condition_variable jobAdded;
+   bool               closed = false;
+   mutex              outMutex;
+
+   auto worker = [&]()
+   {
+      while( true )
+      {
+         string line;
+         {
+            unique_lock<mutex> lock(jobMutex);
+            jobAdded.wait(lock, [&] { return !jobs.empty() || closed; });
+            if( jobs.empty() )
+               return;
+            line = move(jobs.front());
+            jobs.pop_front();
+         }
+
+         string            answer = solveJob(line);
+         lock_guard<mutex> lock(outMutex);
+         out << answer << "\n";
+         out.flush();
+      }
+   };
+
+   vector<thread> workers;
+   for( int k = 0; k < _nbWorkers; ++k )
+   {
+      workers.emplace_back(worker);
+   }
+
+   string line;
+   while( getline(in, line) )
+   {
+      if( line.find_first_not_of(" \t\r") == string::npos )
+         continue;
+
+      {
+         lock_guard<mutex> lock(jobMutex);
+         jobs.push_back(line);
+      }
+      jobAdded.notify_one();
+   }
+
+   {
+      lock_guard<mutex> lock(jobMutex);
+      closed = true;
+   }
+   jobAdded.notify_all();
+
+   for( thread& t : workers )
+   {
+      t.join();
+   }
+}
+
+/**
+ * @brief write the whole string to a socket
+ */
+static bool writeAll(int fd, const string& s)
+{
+   size_t written = 0;
+   while( written < s.size() )
+   {
+      ssize_t n = send(fd, s.data() + written, s.size() - written, MSG_NOSIGNAL);
+      if( n <= 0 )
+         return false;
+      written += n;
+   }
+   return true;
+}
+
+/**
+ * @brief answer the jobs of a single connection
+ *
+ * @note The jobs of a connection are solved one after the other, so the answers have the order of the jobs. Several
+ * connections share the pool.
+ */
+void SolverService::connection(int fd)
+{
+   string buffer;
+   char   chunk[4096];
+
+   while( true )
+   {
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if( n <= 0 )
+         break;
+      buffer.append(chunk, n);
+
+      size_t end;
+      while( (end = buffer.find('\n')) != string::npos )
+      {
+         string line = buffer.substr(0, end);
+         buffer.erase(0, end + 1);
+         if( line.find_first_not_of(" \t\r") == string::npos )
+            continue;
+
+         if( !writeAll(fd, solveJob(line) + "\n") )
+         {
+            close(fd);
+            return;
+         }
+      }
+   }
+
+   close(fd);
+}
+
+/**
+ * @brief answer the jobs of all connections to a Unix socket
+ *
+ * @param path path of the socket, an existing file of this name is removed
+ *
+ * @return always false: the function only returns, if the socket can not be opened or accept() fails, e.g. because
+ * the process has no more file descriptors
+ *
+ * @note Every connection is served by its own thread. The threads of closed connections are joined before the next
+ * connection is accepted, so only the threads of open connections (and of the connections closed since the last
+ * accept) are kept.
+ */
+bool SolverService::serveSocket(const string& path)
+{
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if( path.size() >= sizeof(address.sun_path) )
+   {
+      cerr << "SolverService : socket path too long: " << path << "\n";
+      return false;
+   }
+   strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+   int server = socket(AF_UNIX, SOCK_STREAM, 0);
+   unlink(path.c_str());
+   if( server < 0 || bind(server, (sockaddr*) &address, sizeof(address)) < 0 || listen(server, 16) < 0 )
+   {
+      cerr << "SolverService : can not open the socket " << path << ": " << strerror(errno) << "\n";
+      if( server >= 0 )
+         close(server);
+      return false;
+   }
+
+   cerr << "SolverService : listening on " << path << " with " << _nbWorkers << " workers\n";
+
+   map<thread::id, thread> connections; // threads of the connections
+   vector<thread::id>      finished;    // threads, whose connection is closed
+   mutex                   finishedMutex;
+
+   while( true )
+   {
+      {
+         lock_guard<mutex> lock(finishedMutex);
+         for( thread::id id : finished )
+         {
+            connections[id].join();
+            connections.erase(id);
+         }
+         finished.clear();
+      }
+
+      int fd = accept(server, NULL, NULL);
+      if( fd < 0 )
+      {
+         if( errno == EINTR )
+            continue;
+         break;
+      }
+
+      // the thread is stored before the next reaping, as both happen in this thread
+      thread t(
+         [this, fd, &finished, &finishedMutex]()
+         {
+            connection(fd);
+            lock_guard<mutex> lock(finishedMutex);
+            finished.push_back(this_thread::get_id());
+         });
+      thread::id id   = t.get_id();
+      connections[id] = move(t);
+   }
+
+   cerr << "SolverService : can not accept connections: " << strerror(errno) << "\n";
+   close(server);
+   for( auto& [id, t] : connections )
+   {
+      t.join();
+   }
+
+   return false;
+}
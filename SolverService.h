@@ -0,0 +1,76 @@
+// SolverService.h
+#pragma once
+
+#include "Solver.h"
+
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief long-running service, which answers a stream of jobs with a pool of pre-initialized SCIP environments
+ *
+ * @param _settings settings used for every job
+ *
+ * @param _nbWorkers number of jobs solved at the same time
+ *
+ * @param _pool all SCIP environments, created once with the default plugins, only for the compact model
+ *
+ * @param _idle environments, which are not used by a job at the moment
+ *
+ * @note A job is a single line with a JSON object:
+ * - "id": name of the job (string or number), repeated as "instance" in the answer,
+ * - "capacity" and "weights": the instance, or "file": path of an instance file (see Instance::read()),
+ * - "time_limit": optional time limit of the job in seconds.
+ * Every job is answered by one JSON line (see SolveResult::toJSON()) with the packing of the instance ("packing": bin
+ * of every item), or by {"instance": id, "status": "error", "message": ...}, if the job is malformed. The jobs are read
+ * from a stream (serve(), e.g. stdin, answered in the order of completion) or from the connections of a Unix socket
+ * (serveSocket(), every connection is answered in its own order). Creating a SCIP environment and including the default
+ * plugins dominates the time of a small job, so the environments are created once: a job borrows an idle environment,
+ * the compact model creates its problem in it and frees the problem with SCIPfreeProb() (see CompactModel), and the
+ * environment is returned to the pool. Jobs of the other models do not borrow an environment, so the pool is only
+ * created for the compact model. Only the models, which return a packing (see supportsModel()), can be served. The own
+ * plugins of the compact model (global bin-packing constraint, rounding heuristic, separator, telemetry) hold
+ * references to a single model, so they are switched off.
+ */
+class SolverService
+{
+public:
+   // constructor, nbWorkers jobs are solved at once, the compact model gets a pool of nbWorkers SCIP environments
+   SolverService(const SolverSettings& settings, int nbWorkers);
+
+   // destructor, frees the pool
+   ~SolverService();
+
+   // answer the jobs of a stream with all environments in parallel, until the end of the stream
+   void serve(istream& in, ostream& out);
+
+   // answer the jobs of all connections to a Unix socket, returns only on an error (socket or accept), always false
+   bool serveSocket(const string& path);
+
+   // solve a single job and return the answer as a JSON line (without line break)
+   string solveJob(const string& line);
+
+   // true, if the model returns the packing of a job: compact, portfolio and bnb
+   static bool supportsModel(const string& model);
+
+private:
+   // parse a job, false and an error message, if the job is malformed
+   static bool parseJob(const string& line, string& id, Instance* ins, string& file, double& timeLimit, string& error);
+
+   // take an idle environment, wait, if all environments are used
+   SCIP* acquire();
+
+   // return an environment to the pool
+   void release(SCIP* scip);
+
+   // answer the jobs of a single connection, until it is closed
+   void connection(int fd);
+
+   SolverSettings _settings;  // settings used for every job
+   int            _nbWorkers; // number of jobs solved at the same time
+
+   vector<SCIP*>      _pool;      // all environments
+   vector<SCIP*>      _idle;      // idle environments
+   mutex              _poolMutex; // mutex of _idle
+   condition_variable _released;  // signals a released environment
+};
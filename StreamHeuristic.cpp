@@ -0,0 +1,205 @@
+// StreamHeuristic.cpp
+#include "StreamHeuristic.h"
+#include "Weights.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Construct a new StreamHeuristic:: StreamHeuristic object
+ */
+StreamHeuristic::StreamHeuristic()
+{
+   start(0);
+}
+
+/**
+ * @brief start a new packing, all bins of the last packing are dropped
+ *
+ * @param capacity capacity b of a bin
+ *
+ * @param packing stream, into which the bins of every item are written, nullptr: the packing is not written
+ */
+void StreamHeuristic::start(double capacity, ostream* packing)
+{
+   _capacity       = capacity;
+   _nbItems        = 0;
+   _sum            = 0;
+   _feasible       = true;
+   _nbBinsFirstFit = 0;
+   _nbBinsBestFit  = 0;
+   _nbBinsUsed     = 0;
+   _L1             = 0;
+   _lastClosed     = -1;
+   _packing        = packing;
+
+   // the leaves are empty bins
+   _nbLeaves = 64;
+   _tree.assign(2 * _nbLeaves, capacity);
+   _residuals.clear();
+}
+
+/**
+ * @brief First-Fit with the segment tree
+ *
+ * @note The descent goes to the left child, if the maximal residual of its subtree fits the item, so it ends in the
+ * first bin, which fits. An item, which fits into an empty bin, always finds a leaf, unless all leaves are used, then
+ * the tree is doubled first: the old leaves are copied, the new leaves are empty bins and the inner nodes are rebuilt.
+ */
+int StreamHeuristic::firstFit(double weight)
+{
+   if( !fits(0.0, weight, _tree[1]) )
+   {
+      vector<double> tree(4 * _nbLeaves, _capacity);
+      copy(_tree.begin() + _nbLeaves, _tree.end(), tree.begin() + 2 * _nbLeaves);
+      _nbLeaves *= 2;
+      for( int k = _nbLeaves - 1; k >= 1; --k )
+      {
+         tree[k] = max(tree[2 * k], tree[2 * k + 1]);
+      }
+      _tree.swap(tree);
+   }
+
+   int k = 1;
+   while( k < _nbLeaves )
+   {
+      k = 2 * k;
+      if( !fits(0.0, weight, _tree[k]) )
+         ++k;
+   }
+
+   int bin = k - _nbLeaves;
+   _tree[k] -= weight;
+   for( k /= 2; k >= 1; k /= 2 )
+   {
+      _tree[k] = max(_tree[2 * k], _tree[2 * k + 1]);
+   }
+
+   _nbBinsFirstFit = max(_nbBinsFirstFit, bin + 1);
+   return bin;
+}
+
+/**
+ * @brief Best-Fit with the balanced search tree of the open bins
+ *
+ * @note The first entry, whose residual is at least the weight minus the tolerance of fits(), is the fullest bin,
+ * which fits the item. A full bin is removed from the tree, only an item without weight can still be packed into it.
+ */
+int StreamHeuristic::bestFit(double weight)
+{
+   if( _lastClosed >= 0 && fits(0.0, weight, 0.0) )
+      return _lastClosed;
+
+   auto   it = _residuals.lower_bound(make_pair(weight - 1e-9, -1));
+   int    bin;
+   double residual;
+   if( it == _residuals.end() )
+   {
+      // open a new bin
+      bin      = _nbBinsBestFit++;
+      residual = _capacity - weight;
+   }
+   else
+   {
+      bin      = it->second;
+      residual = it->first - weight;
+      _residuals.erase(it);
+   }
+
+   // a bin is full, if its residual is within the tolerance
+   if( residual > 1e-9 )
+      _residuals.emplace(residual, bin);
+   else
+      _lastClosed = bin;
+
+   return bin;
+}
+
+/**
+ * @brief pack a single item by First-Fit and Best-Fit, and write its bins into the packing stream
+ *
+ * @param weight weight of the item, at least 0
+ */
+void StreamHeuristic::add(double weight)
+{
+   ++_nbItems;
+   _sum += weight;
+
+   int binFirstFit = -1;
+   int binBestFit  = -1;
+   if( fits(0.0, weight, _capacity) )
+   {
+      binFirstFit = firstFit(weight);
+      binBestFit  = bestFit(weight);
+   }
+   else
+      _feasible = false;
+
+   if( _packing != nullptr )
+      *_packing << binFirstFit << " " << binBestFit << "\n";
+}
+
+/**
+ * @brief compute the continuous bound and the better number of bins, and free the bins
+ *
+ * @note The bound has the same tolerance as L1 in LowerBound for fractional weights.
+ */
+void StreamHeuristic::finish()
+{
+   _L1         = _capacity > 0 ? (int) ceil(_sum / _capacity - 1e-9) : 0;
+   _nbBinsUsed = min(_nbBinsFirstFit, _nbBinsBestFit);
+
+   vector<double>().swap(_tree);
+   _residuals.clear();
+}
+
+/**
+ * @brief read an instance file and pack its items, while it is read
+ *
+ * @param nameFile path to the .bpp-file
+ *
+ * @param packing stream, into which the bins of every item are written, nullptr: the packing is not written
+ *
+ * @return true, if the file was read, false if the file is missing or malformed (the numbers are incomplete then)
+ *
+ * @note The capacity is known before the first weight (see Instance::stream()), so the packing is started with the
+ * first item, or after the file, if it has no items.
+ */
+bool StreamHeuristic::run(const string& nameFile, ostream* packing)
+{
+   Instance ins;
+   bool     started = false;
+   bool     read    = ins.stream(nameFile,
+                          [&](double weight)
+                          {
+                             if( !started )
+                             {
+                                start(ins.par_b, packing);
+                                started = true;
+                             }
+                             add(weight);
+                          });
+
+   if( !started )
+      start(ins.par_b, packing);
+   finish();
+
+   return read;
+}
+
+/**
+ * @brief display the number of bins of both packings and the bound
+ */
+void StreamHeuristic::display()
+{
+   if( !_feasible )
+   {
+      cout << "StreamHeuristic: " << _nbItems << " items, no feasible packing" << endl;
+      return;
+   }
+
+   cout << "StreamHeuristic: " << _nbItems << " items, First-Fit " << _nbBinsFirstFit << " bins, Best-Fit "
+        << _nbBinsBestFit << " bins, bound L1 " << _L1 << endl;
+   if( _L1 > 0 )
+      cout << "gap to L1: " << 100.0 * (_nbBinsUsed - _L1) / _L1 << " %" << endl;
+}
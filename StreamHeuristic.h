@@ -0,0 +1,76 @@
+// StreamHeuristic.h
+#pragma once
+
+#include "Instance.h"
+
+#include <set>
+
+/**
+ * @brief online First-Fit and Best-Fit for instances, which are too large for a model or for storing the items
+ *
+ * @param _capacity capacity b of a bin
+ *
+ * @param _nbItems number of items
+ *
+ * @param _nbBinsFirstFit, _nbBinsBestFit number of bins used by First-Fit and Best-Fit
+ *
+ * @param _nbBinsUsed number of bins of the better packing
+ *
+ * @param _L1 continuous lower bound ceil(sum of weights / b), a certificate of the quality of the packings
+ *
+ * @note The items are packed in the order of the file, while it is read (see Instance::stream()), so no weight and no
+ * bin of an item is stored, and the memory only depends on the number of bins. First-Fit keeps the residual capacity
+ * of every bin in the leaves of a segment tree, whose inner nodes hold the maximal residual of their subtree: the first
+ * bin, which fits an item, is found by a single descent in O(log m) for m bins. The leaves behind the used bins are
+ * empty bins, so the descent opens a new bin, if no used bin fits, and the tree is doubled, when it is full. Best-Fit
+ * keeps the residual capacities of its open bins in a balanced search tree (std::multiset), the smallest sufficient
+ * residual is found by lower_bound() in O(log m), and a bin is closed, as soon as it is full. The weights are doubles,
+ * sums of integral weights below 2^53 are exact, fractional weights are compared with the tolerance of fits(). An item,
+ * which is heavier than the capacity, makes the instance infeasible and is not packed. If a packing stream is given,
+ * the bins of every item in both packings are written into it, one line "First-Fit bin, Best-Fit bin" per item
+ * (-1 for an item, which is not packed).
+ */
+class StreamHeuristic
+{
+public:
+   // constructor
+   StreamHeuristic();
+
+   // read the instance file and pack all its items, false if the file is missing or malformed
+   bool run(const string& nameFile, ostream* packing = nullptr);
+
+   // start a new packing with the given capacity
+   void start(double capacity, ostream* packing = nullptr);
+
+   // pack a single item by First-Fit and Best-Fit
+   void add(double weight);
+
+   // compute the bound and free the bins, after the last item
+   void finish();
+
+   // display the number of bins and the bound
+   void display();
+
+   double _capacity;       // capacity b of a bin
+   int    _nbItems;        // number of items
+   double _sum;            // sum of the weights of all items
+   bool   _feasible;       // true, if every item fits into an empty bin
+   int    _nbBinsFirstFit; // number of bins used by First-Fit
+   int    _nbBinsBestFit;  // number of bins used by Best-Fit
+   int    _nbBinsUsed;     // number of bins of the better packing
+   int    _L1;             // continuous lower bound
+
+private:
+   // First-Fit: pack the item into the first bin, which fits it, and return the bin
+   int firstFit(double weight);
+
+   // Best-Fit: pack the item into the fullest bin, which fits it, and return the bin
+   int bestFit(double weight);
+
+   vector<double>              _tree;       // segment tree of First-Fit, node k has the children 2k and 2k + 1
+   int                         _nbLeaves;   // number of leaves of the segment tree, a power of two
+   multiset<pair<double, int>> _residuals;  // residual capacity and index of every open bin of Best-Fit
+   int                         _lastClosed; // last full bin of Best-Fit, -1 if there is none
+
+   ostream* _packing; // stream of the bins of every item, nullptr if the packing is not written
+};
@@ -0,0 +1,60 @@
+// Weights.h
+#pragma once
+
+#include "Instance.h"
+
+#include <climits>
+#include <cstdint>
+
+/**
+ * @brief capacity check of a bin: does an item of the given weight fit on top of the load?
+ *
+ * @note Integral weights are compared exactly. Fractional weights are compared with a small tolerance, so a bin,
+ * which is exactly filled, is not rejected because of rounding errors in the sum of the weights.
+ */
+template <typename W>
+inline bool fits(W load, W weight, W capacity)
+{
+   return load + weight <= capacity;
+}
+
+template <>
+inline bool fits<double>(double load, double weight, double capacity)
+{
+   return load + weight <= capacity + 1e-9;
+}
+
+/**
+ * @brief call a kernel with the weights and the capacity of an instance in the narrowest exact type
+ *
+ * @param ins pointer to the instance
+ *
+ * @param kernel generic callable kernel(const vector<W>& weight, W capacity)
+ *
+ * @return the return value of the kernel
+ *
+ * @note The type is chosen at run time: int32_t, if the instance is integral and the sum of all weights fits into 32
+ * bits (so no load can overflow), long long for other integral instances (their sum is below 2^58, see
+ * Instance::setIntegral()) and double otherwise. The kernel is a template, which is instantiated for all three types,
+ * so the loops of the integer versions work on exact and compact integer arrays.
+ */
+template <typename KERNEL>
+auto withWeights(const Instance* ins, KERNEL&& kernel)
+{
+   if( !ins->_integral )
+      return kernel(ins->par_w, ins->par_b);
+
+   long long total = ins->int_b;
+   for( long long w : ins->int_w )
+   {
+      total += w;
+   }
+
+   if( total <= INT32_MAX )
+   {
+      vector<int32_t> weight(ins->int_w.begin(), ins->int_w.end());
+      return kernel(weight, (int32_t) ins->int_b);
+   }
+
+   return kernel(ins->int_w, ins->int_b);
+}
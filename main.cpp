@@ -1,40 +1,208 @@
-#include "CompactModel.h"
+#include "BatchSolver.h"
+#include "Solver.h"
+#include "SolverService.h"
+
+#include <charconv>
+#include <cstring>
+#include <thread>
+
+/**
+ * @brief print the command line options
+ */
+static void printUsage(const char* program)
+{
+   cout << "usage: " << program << " [options] [file.bpp | directory]...\n"
+        << "options:\n"
+        << "  --model <name>             model to solve: compact, pattern, arcflow, bnb, portfolio or stream\n"
+        << "                             (default: compact)\n"
+        << "  --symmetry                 compact model with symmetry breaking\n"
+        << "  --production               compact model without names for variables and constraints\n"
+        << "  --binpacking               compact model with the global bin-packing constraint\n"
+        << "  --rounding <freq>          compact model with the LP rounding heuristic every freq-th depth (0: root only)\n"
+        << "  --cuts <freq>              compact model with bin-packing cuts every freq-th depth (0: root only)\n"
+        << "  --portfolio-size <n>       number of compact-model configurations of the portfolio (default: all cores,\n"
+        << "                             divided by --threads in batch and service mode)\n"
+        << "  --packing-file <file>      stream model: write the First-Fit and the Best-Fit bin of every item into a file\n"
+        << "                             (single instance)\n"
+        << "  --write-lp <file>          write the LP-model of the compact model into a file (single instance)\n"
+        << "  --no-reduce                solve the full instance without the reduction\n"
+        << "  --no-bounds                build the model even if the heuristic reaches the lower bounds\n"
+        << "  --telemetry                record the bound trajectory and the statistics of SCIP as JSON\n"
+        << "  --time-limit <s>           time limit per instance in seconds\n"
+        << "  --threads <n>              number of worker threads in batch mode (default: all cores)\n"
+        << "  --output <file>            result file of the batch mode, .csv or .jsonl (default: results.csv)\n"
+        << "  --serve                    service mode: answer JSON jobs from stdin, one JSON line per job\n"
+        << "  --socket <path>            service mode: answer JSON jobs from the connections to a Unix socket\n"
+        << "A single file without --output is solved verbosely, everything else is solved in batch mode.\n"
+        << "In service mode, --threads is the number of jobs solved at once (and of the pooled SCIP environments of\n"
+        << "the compact model); only the models compact, portfolio and bnb return the packing of a job.\n";
+}
+
+/**
+ * @brief convert a complete command line argument into a number
+ *
+ * @return true, if the argument is a number, false for an empty argument, other characters or a value out of range
+ */
+template <typename T>
+static bool parseNumber(const char* text, T& value)
+{
+   const char* end = text + strlen(text);
+   auto [ptr, ec]  = from_chars(text, end, value);
+   return ptr != text && ec == errc() && ptr == end;
+}
 
 /**
  * @brief main-function
  *
+ * @param argc number of arguments
+ *
+ * @param argv arguments: options and paths of instance files or directories
+ *
  * @return int
  *
- * @note This code creates an instance of a problem, reads in the data from a file, displays the data, creates a compact
- * model of the instance, solves the model, and displays the solution. The instance name is hardcoded as
- * "../data/Ins_01.bpp". The main function takes two parameters: argc (the number of arguments) and argv (an array of
- * strings containing the arguments). The function returns 0 upon completion.
+ * @note This code parses the command line and solves either a single instance or a batch of instances. Without any
+ * path, the instance "../data/Ins_01.bpp" is solved. A single instance is solved verbosely: the instance, the
+ * heuristic packing, the SCIP output and the solution are displayed (see solveInstance()). If several files, a
+ * directory or a result file are given, all instances are solved in parallel by the BatchSolver and one line per
+ * instance is written to the result file. With --serve or --socket, the program runs as a SolverService, which answers
+ * jobs until stdin ends (or the socket fails). The function returns 0 upon completion, 1 for invalid arguments, an
+ * unreadable single instance, a result file or a socket, which can not be opened.
  */
-int main()
+int main(int argc, char** argv)
 {
    //#####################################################################################################################
    // Settings
-   string InstanceName = "../data/Ins_01.bpp";
+   vector<string> InstanceNames;
+   SolverSettings settings;
+   string         OutputName;
+   int            NbThreads = max(1, (int) thread::hardware_concurrency());
+   bool           Serve     = false;
+   string         SocketName;
+
+   for( int a = 1; a < argc; ++a )
+   {
+      string arg   = argv[a];
+      bool   valid = true; // false, if the value of an option is no number or out of range
+
+      if( arg == "--model" && a + 1 < argc )
+         settings._model = argv[++a];
+      else if( arg == "--symmetry" )
+         settings._symmetryBreaking = true;
+      else if( arg == "--production" )
+         settings._production = true;
+      else if( arg == "--binpacking" )
+         settings._binPacking = true;
+      else if( arg == "--rounding" && a + 1 < argc )
+         valid = parseNumber(argv[++a], settings._roundingFreq);
+      else if( arg == "--cuts" && a + 1 < argc )
+         valid = parseNumber(argv[++a], settings._cutsFreq);
+      else if( arg == "--portfolio-size" && a + 1 < argc )
+         valid = parseNumber(argv[++a], settings._portfolioSize);
+      else if( arg == "--packing-file" && a + 1 < argc )
+         settings._packingFile = argv[++a];
+      else if( arg == "--no-reduce" )
+         settings._reduce = false;
+      else if( arg == "--no-bounds" )
+         settings._bounds = false;
+      else if( arg == "--telemetry" )
+         settings._telemetry = true;
+      else if( arg == "--write-lp" && a + 1 < argc )
+         settings._lpFile = argv[++a];
+      else if( arg == "--time-limit" && a + 1 < argc )
+         valid = parseNumber(argv[++a], settings._timeLimit) && settings._timeLimit >= 0;
+      else if( arg == "--threads" && a + 1 < argc )
+         valid = parseNumber(argv[++a], NbThreads) && NbThreads >= 1;
+      else if( arg == "--output" && a + 1 < argc )
+         OutputName = argv[++a];
+      else if( arg == "--serve" )
+         Serve = true;
+      else if( arg == "--socket" && a + 1 < argc )
+         SocketName = argv[++a];
+      else if( arg.rfind("--", 0) == 0 )
+      {
+         printUsage(argv[0]);
+         return 1;
+      }
+      else
+         InstanceNames.push_back(arg);
+
+      if( !valid )
+      {
+         cout << "invalid value of " << arg << ": " << argv[a] << "\n";
+         printUsage(argv[0]);
+         return 1;
+      }
+   }
+
+   if( settings._model != "compact" && settings._model != "pattern" && settings._model != "arcflow"
+       && settings._model != "bnb" && settings._model != "portfolio" && settings._model != "stream" )
+   {
+      printUsage(argv[0]);
+      return 1;
+   }
 
    //#####################################################################################################################
-   // read and display the instance
-   Instance* ins = new Instance();
-   ins->read(InstanceName);
-   ins->display();
+   // service mode: answer jobs, until stdin ends or the socket fails
+   if( Serve || !SocketName.empty() )
+   {
+      // every job is answered with its packing
+      if( !SolverService::supportsModel(settings._model) )
+      {
+         cout << "service mode needs a model, which returns the packing: compact, portfolio or bnb\n";
+         printUsage(argv[0]);
+         return 1;
+      }
+
+      // NbThreads jobs are solved at once, so every portfolio gets its share of the cores
+      if( settings._portfolioSize <= 0 )
+         settings._portfolioSize = max(1, (int) thread::hardware_concurrency() / NbThreads);
+
+      SolverService* service = new SolverService(settings, NbThreads);
+      bool           ok      = true;
+      if( SocketName.empty() )
+         service->serve(cin, cout);
+      else
+         ok = service->serveSocket(SocketName);
+      delete service;
+      return ok ? 0 : 1;
+   }
+
+   if( InstanceNames.empty() )
+      InstanceNames.push_back("../data/Ins_01.bpp");
+
+   vector<string> files = BatchSolver::collectFiles(InstanceNames);
 
    //#####################################################################################################################
-   // create compact problem
+   // single instance: solve verbosely
+   if( files.size() == 1 && OutputName.empty() && InstanceNames[0] == files[0] )
+   {
+      SolveResult result = solveInstance(files[0], settings);
+      if( settings._telemetry )
+         cout << result.toJSON() << "\n";
+      return result._status == "error" ? 1 : 0;
+   }
+
+   //#####################################################################################################################
+   // batch mode: solve all instances in parallel
+   settings._verbose = false;
+
+   // NbThreads instances are solved at once, so every portfolio gets its share of the cores
+   if( settings._portfolioSize <= 0 )
+      settings._portfolioSize = max(1, (int) thread::hardware_concurrency() / NbThreads);
 
-   // Use the Constructor to create the instance "compMod" of the class CompactModel
-   CompactModel* compMod = new CompactModel(ins);
+   // every job would write its model or its packing into the same file
+   if( !settings._lpFile.empty() || !settings._packingFile.empty() )
+   {
+      cout << (settings._lpFile.empty() ? "--packing-file" : "--write-lp") << " needs a single instance\n";
+      printUsage(argv[0]);
+      return 1;
+   }
 
-   // call the function "solve" to solve the model and the function "display" to show the solution
-   compMod->solve();
-   compMod->displaySolution();
+   BatchSolver* batch = new BatchSolver(files, settings, OutputName.empty() ? "results.csv" : OutputName);
+   bool         ok    = batch->run(NbThreads);
 
    // after we are finished, we free the memory
-   delete compMod;
-   delete ins;
+   delete batch;
 
-   return 0;
-}
\ No newline at end of file
+   return ok ? 0 : 1;
+}